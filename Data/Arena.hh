@@ -15,6 +15,7 @@ class Arena {
 
 public:
 	Arena() {}
+	Arena(int c, Coordinates2D a) : code(c), address(a) {}
 	int Code() const { return code; }
 	Coordinates2D Address() const { return address; }
 
@@ -14,6 +14,7 @@ class Division {
 
 public:
 	Division() {}
+	Division(int c, int minR, int maxR, int l, int t) : code(c), minReferees(minR), maxReferees(maxR), level(l), teams(t) {}
 	int Code() const { return code; }
 	int MinReferees() const { return minReferees; }
 	int MaxReferees() const { return maxReferees; }
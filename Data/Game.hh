@@ -16,6 +16,7 @@ class Game {
 
 public:
 	Game() {}
+	Game(int h, int a, int d, Event m, int ar, int e) : homeTeam(h), awayTeam(a), division(d), match(m), arena(ar), experience(e) {}
 	int HomeTeam() const { return homeTeam; }
 	int AwayTeam() const { return awayTeam; }
 	int Division() const { return division; }
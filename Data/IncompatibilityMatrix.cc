@@ -0,0 +1,110 @@
+// File IncompatibilityMatrix.cc
+
+#include <algorithm>
+#include "IncompatibilityMatrix.hh"
+
+IncompatibilityMatrix::IncompatibilityMatrix(int r, int c, const vector<vector<int>>& entries)
+	: rows(r), columns(c), words((c + 64) / 64) {
+	size_t nonZeros = 0;
+
+	for (const vector<int>& row : entries)
+		nonZeros += row.size();
+
+	dense = static_cast<size_t>(rows) * words * sizeof(uint64_t) <= maxDenseBytes || nonZeros * 64 >= static_cast<size_t>(rows) * columns;
+
+	if (dense) {
+		bits.assign(static_cast<size_t>(rows) * words, 0);
+		for (int i = 1; i <= rows; i++)
+			for (int j : entries[i - 1])
+				if (j >= 1 && j <= columns)
+					bits[(i - 1) * words + j / 64] |= uint64_t(1) << (j % 64);
+	} else {
+		sparse = entries;
+		for (vector<int>& row : sparse)
+			sort(row.begin(), row.end());
+	}
+}
+
+bool IncompatibilityMatrix::Incompatible(int i, int j) const {
+	if (dense)
+		return (bits[(i - 1) * words + j / 64] >> (j % 64)) & 1;
+	else
+		return binary_search(sparse[i - 1].begin(), sparse[i - 1].end(), j);
+}
+
+/*	The buffer is left cleared after each use (by ClearMask), so that only
+	the words of the set are touched, whatever the number of columns.
+*/
+static thread_local vector<uint64_t> maskBuffer;
+
+const uint64_t* IncompatibilityMatrix::Mask(const set<int>& js) const {
+	if (maskBuffer.size() < static_cast<size_t>(words))
+		maskBuffer.resize(words, 0);
+	for (int j : js)
+		maskBuffer[j / 64] |= uint64_t(1) << (j % 64);
+	return maskBuffer.data();
+}
+
+void IncompatibilityMatrix::ClearMask(const set<int>& js) {
+	for (int j : js)
+		maskBuffer[j / 64] = 0;
+}
+
+int IncompatibilityMatrix::Count(int i, const set<int>& js) const {
+	int count = 0;
+
+	if (js.empty())
+		return 0;
+
+	if (dense) {
+		const uint64_t *mask = Mask(js), *row = &bits[(i - 1) * words];
+		int first = *js.begin() / 64, last = *js.rbegin() / 64;
+
+		for (int w = first; w <= last; w++)
+			count += __builtin_popcountll(row[w] & mask[w]);
+		ClearMask(js);
+	} else {
+		const vector<int>& row = sparse[i - 1];
+		vector<int>::const_iterator it = row.begin();
+		set<int>::const_iterator jt = js.begin();
+
+		while (it != row.end() && jt != js.end())
+			if (*it < *jt)
+				++it;
+			else if (*jt < *it)
+				++jt;
+			else {
+				count++;
+				++it;
+				++jt;
+			}
+	}
+
+	return count;
+}
+
+int IncompatibilityMatrix::CountPairs(const set<int>& is) const {
+	int count = 0;
+
+	if (is.size() < 2)
+		return 0;
+
+	if (dense) {
+		const uint64_t *mask = Mask(is);
+		int first = *is.begin() / 64, last = *is.rbegin() / 64;
+
+		for (int i : is) {
+			const uint64_t *row = &bits[(i - 1) * words];
+
+			for (int w = first; w <= last; w++)
+				count += __builtin_popcountll(row[w] & mask[w]);
+			// a row incompatible with itself is not a pair
+			count -= (row[i / 64] >> (i % 64)) & 1;
+		}
+		ClearMask(is);
+	} else
+		for (int i : is)
+			count += Count(i, is) - (Incompatible(i, i) ? 1 : 0);
+
+	return count;
+}
@@ -0,0 +1,43 @@
+// File IncompatibilityMatrix.hh
+
+#ifndef INCOMPATIBILITY_MATRIX_HH
+#define INCOMPATIBILITY_MATRIX_HH
+
+#include <vector>
+#include <set>
+#include <cstdint>
+
+using namespace std;
+
+/*	Boolean matrix of the incompatibilities (e.g. of the referees with the
+	referees or of the teams with the referees), with rows and columns from 1.
+	It is stored as a bitset, one row of 64-bit words after the other, unless
+	the matrix is both large (more than maxDenseBytes of bits) and sparse
+	(less than one entry every 64 columns on average), in which case each row
+	keeps the sorted array of its columns. With the bitset the counts over a
+	set of columns are popcounts of the row and the mask of the set, with the
+	sorted arrays they are merges of the row and the set.
+*/
+class IncompatibilityMatrix {
+
+public:
+	IncompatibilityMatrix() : rows(0), columns(0), words(0), dense(true) {}
+	IncompatibilityMatrix(int r, int c, const vector<vector<int>>& entries);	// entries[i - 1] are the columns of the row i
+	bool Incompatible(int i, int j) const;
+	int Count(int i, const set<int>& js) const;	// number of columns of js incompatible with the row i
+	int CountPairs(const set<int>& is) const;	// number of ordered pairs (i, j) of is, i != j, with i incompatible with j (square matrices)
+	bool Dense() const { return dense; }
+
+private:
+	static const size_t maxDenseBytes = 1 << 20;	// below this size the bitset is used at any density
+	const uint64_t* Mask(const set<int>& js) const;	// the bits of js, in a buffer of the calling thread (words long)
+	static void ClearMask(const set<int>& js);
+
+	int rows, columns, words;
+	bool dense;
+	vector<uint64_t> bits;	// dense: the words of the row i are [(i - 1) * words, i * words)
+	vector<vector<int>> sparse;	// sparse: the sorted columns of each row
+
+};
+
+#endif
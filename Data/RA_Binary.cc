@@ -0,0 +1,328 @@
+// File RA_Binary.cc
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RA_Binary.hh"
+
+const char RA_BinaryInstance::magic[8] = { 'R', 'A', 'B', 'I', 'N', 'S', 'T', '\0' };
+
+namespace {
+
+const uint32_t byteOrderMark = 0x01020304;
+
+int32_t PackDate(const Date& d) { return d.Year() * 10000 + d.Month() * 100 + d.Day(); }
+Date UnpackDate(int32_t d) { return Date(d % 100, d / 100 % 100, d / 10000); }
+int32_t PackTime(const Time& t) { return t.TimeInMinutes(); }
+Time UnpackTime(int32_t t) { return Time(t / 60, t % 60); }
+
+// the arrays are appended to a buffer, each one padded to 8 bytes
+class Writer {
+public:
+	explicit Writer(size_t headerSize) : buffer(headerSize, 0) {}
+	template <typename T> void Put(const vector<T>& v) {
+		const char *data = reinterpret_cast<const char*>(v.data());
+		buffer.insert(buffer.end(), data, data + v.size() * sizeof(T));
+		buffer.resize((buffer.size() + 7) / 8 * 8, 0);
+	}
+	vector<char> buffer;
+};
+
+// reads the arrays in the same order, checking that they lie in the file
+class Reader {
+public:
+	Reader(const char* d, size_t s, size_t headerSize, const string& f) : data(d), size(s), position(headerSize), fileName(f) {}
+	template <typename T> const T* Get(size_t n) {
+		const T *array = reinterpret_cast<const T*>(data + position);
+		if (position > size || n > (size - position) / sizeof(T)) {
+			cerr << "Truncated binary instance " << fileName << endl;
+			exit(1);
+		}
+		position = (position + n * sizeof(T) + 7) / 8 * 8;
+		return array;
+	}
+	// the n + 1 offsets of a list start from 0, do not decrease and end at the length of the values
+	const int32_t* GetOffsets(int n, int32_t length, const char* what) {
+		const int32_t *start = Get<int32_t>(n + 1);
+		if (start[0] != 0 || start[n] != length)
+			Reject(what);
+		for (int i = 0; i < n; i++)
+			if (start[i] > start[i + 1])
+				Reject(what);
+		return start;
+	}
+	// the n values are indices in [first, last]
+	const int32_t* GetIndices(size_t n, int32_t first, int32_t last, const char* what) {
+		const int32_t *array = Get<int32_t>(n);
+		for (size_t i = 0; i < n; i++)
+			if (array[i] < first || array[i] > last)
+				Reject(what);
+		return array;
+	}
+	void Reject(const char* what) {
+		cerr << "Corrupted binary instance " << fileName << " (" << what << ")" << endl;
+		exit(1);
+	}
+private:
+	const char *data;
+	size_t size, position;
+	const string& fileName;
+};
+
+}
+
+bool RA_BinaryInstance::IsBinary(const string& fileName) {
+	ifstream is(fileName, ios::binary);
+	char m[sizeof(magic)];
+
+	return is.read(m, sizeof(m)) && memcmp(m, magic, sizeof(magic)) == 0;
+}
+
+void RA_BinaryInstance::Write(const RA_Input& in, const string& fileName) {
+	Header header;
+	Writer w(sizeof(Header));
+	int D = in.NumDivisions(), R = in.NumReferees(), A = in.NumArenas(), T = in.NumTeams(), G = in.NumGames();
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.byteOrder = byteOrderMark;
+	header.numDivisions = D;
+	header.numReferees = R;
+	header.numArenas = A;
+	header.numTeams = T;
+	header.numGames = G;
+	header.numDates = in.NumDates();
+
+	// DIVISIONS
+	vector<int32_t> code(D), minReferees(D), maxReferees(D), level(D), teams(D);
+	for (int d = 1; d <= D; d++) {
+		const Division &division = in.GetDivision(d);
+		code[d - 1] = division.Code();
+		minReferees[d - 1] = division.MinReferees();
+		maxReferees[d - 1] = division.MaxReferees();
+		level[d - 1] = division.Level();
+		teams[d - 1] = division.Teams();
+	}
+	w.Put(code); w.Put(minReferees); w.Put(maxReferees); w.Put(level); w.Put(teams);
+
+	// REFEREES
+	vector<int32_t> experience(R), incompatibleRefereesStart(1, 0), incompatibleReferees, incompatibleTeamsStart(1, 0), incompatibleTeams;
+	vector<int32_t> unavailabilitiesStart(1, 0), startDate, startTime, endDate, endTime;
+	vector<double> x(R), y(R);
+	code.assign(R, 0);
+	level.assign(R, 0);
+	for (int r = 1; r <= R; r++) {
+		const Referee &referee = in.GetReferee(r);
+		code[r - 1] = referee.Code();
+		level[r - 1] = referee.Level();
+		experience[r - 1] = referee.Experience();
+		x[r - 1] = referee.Address().X();
+		y[r - 1] = referee.Address().Y();
+		incompatibleReferees.insert(incompatibleReferees.end(), referee.IncompatibleReferees().begin(), referee.IncompatibleReferees().end());
+		incompatibleRefereesStart.push_back(incompatibleReferees.size());
+		incompatibleTeams.insert(incompatibleTeams.end(), referee.IncompatibleTeams().begin(), referee.IncompatibleTeams().end());
+		incompatibleTeamsStart.push_back(incompatibleTeams.size());
+		for (const Event& e : referee.Unavailabilities()) {
+			startDate.push_back(PackDate(e.StartDate()));
+			startTime.push_back(PackTime(e.StartTime()));
+			endDate.push_back(PackDate(e.EndDate()));
+			endTime.push_back(PackTime(e.EndTime()));
+		}
+		unavailabilitiesStart.push_back(startDate.size());
+	}
+	header.numIncompatibleReferees = incompatibleReferees.size();
+	header.numIncompatibleTeams = incompatibleTeams.size();
+	header.numUnavailabilities = startDate.size();
+	w.Put(code); w.Put(level); w.Put(experience); w.Put(x); w.Put(y);
+	w.Put(incompatibleRefereesStart); w.Put(incompatibleReferees);
+	w.Put(incompatibleTeamsStart); w.Put(incompatibleTeams);
+	w.Put(unavailabilitiesStart); w.Put(startDate); w.Put(startTime); w.Put(endDate); w.Put(endTime);
+
+	// ARENAS
+	code.assign(A, 0);
+	x.assign(A, 0.0);
+	y.assign(A, 0.0);
+	for (int a = 1; a <= A; a++) {
+		code[a - 1] = in.GetArena(a).Code();
+		x[a - 1] = in.GetArena(a).Address().X();
+		y[a - 1] = in.GetArena(a).Address().Y();
+	}
+	w.Put(code); w.Put(x); w.Put(y);
+
+	// TEAMS
+	vector<int32_t> division(T);
+	code.assign(T, 0);
+	for (int t = 1; t <= T; t++) {
+		code[t - 1] = in.GetTeam(t).Code();
+		division[t - 1] = in.GetTeam(t).Division();
+	}
+	w.Put(code); w.Put(division);
+
+	// GAMES (sorted)
+	vector<int32_t> homeTeam(G), awayTeam(G), arena(G);
+	division.assign(G, 0);
+	experience.assign(G, 0);
+	startDate.assign(G, 0);
+	startTime.assign(G, 0);
+	endDate.assign(G, 0);
+	endTime.assign(G, 0);
+	for (int g = 1; g <= G; g++) {
+		const Game &game = in.GetGame(g);
+		homeTeam[g - 1] = game.HomeTeam();
+		awayTeam[g - 1] = game.AwayTeam();
+		division[g - 1] = game.Division();
+		arena[g - 1] = game.Arena();
+		experience[g - 1] = game.Experience();
+		startDate[g - 1] = PackDate(game.Match().StartDate());
+		startTime[g - 1] = PackTime(game.Match().StartTime());
+		endDate[g - 1] = PackDate(game.Match().EndDate());
+		endTime[g - 1] = PackTime(game.Match().EndTime());
+	}
+	w.Put(homeTeam); w.Put(awayTeam); w.Put(division); w.Put(arena); w.Put(experience);
+	w.Put(startDate); w.Put(startTime); w.Put(endDate); w.Put(endTime);
+
+	// INDICES
+	vector<int32_t> firstGameOfDate, gameDate(G), teamGamesStart(1, 0), teamGames;
+	for (int d = 1; d <= in.NumDates() + 1; d++)
+		firstGameOfDate.push_back(in.FirstGameOfDate(d));
+	for (int g = 1; g <= G; g++)
+		gameDate[g - 1] = in.DateOf(g);
+	for (int t = 1; t <= T; t++) {
+		teamGames.insert(teamGames.end(), in.TeamGames(t).begin(), in.TeamGames(t).end());
+		teamGamesStart.push_back(teamGames.size());
+	}
+	w.Put(firstGameOfDate); w.Put(gameDate); w.Put(teamGamesStart); w.Put(teamGames);
+
+	header.fileSize = w.buffer.size();
+	memcpy(w.buffer.data(), &header, sizeof(header));
+
+	ofstream os(fileName, ios::binary);
+	if (!os.write(w.buffer.data(), w.buffer.size())) {
+		cerr << "Cannot write file " << fileName << endl;
+		exit(1);
+	}
+}
+
+void RA_BinaryInstance::Read(const string& fileName, RA_Input& in) {
+	struct stat st;
+	Header header;
+	int fd = open(fileName.c_str(), O_RDONLY);
+
+	if (fd < 0 || fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+		cerr << "Cannot open file " << fileName << endl;
+		exit(1);
+	}
+
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED) {
+		cerr << "Cannot map file " << fileName << endl;
+		exit(1);
+	}
+	const char *data = static_cast<const char*>(mapping);
+
+	memcpy(&header, data, sizeof(header));
+	if (header.version != version || header.byteOrder != byteOrderMark || header.fileSize != static_cast<uint64_t>(st.st_size)) {
+		cerr << "Unsupported binary instance " << fileName << " (version " << header.version << ", expected " << version << ")" << endl;
+		exit(1);
+	}
+
+	Reader r(data, st.st_size, sizeof(Header), fileName);
+	int D = header.numDivisions, R = header.numReferees, A = header.numArenas, T = header.numTeams, G = header.numGames;
+
+	if (D < 0 || R < 0 || A < 0 || T < 0 || G < 0 || header.numDates < 0 || header.numIncompatibleReferees < 0 ||
+		header.numIncompatibleTeams < 0 || header.numUnavailabilities < 0)
+		r.Reject("negative count");
+
+	in.numDivisions = D;
+	in.numReferees = R;
+	in.numArenas = A;
+	in.numTeams = T;
+	in.numGames = G;
+
+	// DIVISIONS
+	const int32_t *code = r.Get<int32_t>(D), *minReferees = r.Get<int32_t>(D), *maxReferees = r.Get<int32_t>(D);
+	const int32_t *level = r.Get<int32_t>(D), *teams = r.Get<int32_t>(D);
+	in.tables->divisions.reserve(D);
+	for (int d = 0; d < D; d++)
+		in.tables->divisions.emplace_back(code[d], minReferees[d], maxReferees[d], level[d], teams[d]);
+
+	// REFEREES
+	code = r.Get<int32_t>(R);
+	level = r.Get<int32_t>(R);
+	const int32_t *experience = r.Get<int32_t>(R);
+	const double *x = r.Get<double>(R), *y = r.Get<double>(R);
+	const int32_t *incompatibleRefereesStart = r.GetOffsets(R, header.numIncompatibleReferees, "incompatible referees");
+	// the code 0 (no referee or team) is accepted in the incompatibilities, as by RA_TextParser
+	const int32_t *incompatibleReferees = r.GetIndices(header.numIncompatibleReferees, 0, R, "incompatible referees");
+	const int32_t *incompatibleTeamsStart = r.GetOffsets(R, header.numIncompatibleTeams, "incompatible teams");
+	const int32_t *incompatibleTeams = r.GetIndices(header.numIncompatibleTeams, 0, T, "incompatible teams");
+	const int32_t *unavailabilitiesStart = r.GetOffsets(R, header.numUnavailabilities, "unavailabilities");
+	const int32_t *startDate = r.Get<int32_t>(header.numUnavailabilities), *startTime = r.Get<int32_t>(header.numUnavailabilities);
+	const int32_t *endDate = r.Get<int32_t>(header.numUnavailabilities), *endTime = r.Get<int32_t>(header.numUnavailabilities);
+	in.tables->referees.reserve(R);
+	for (int i = 0; i < R; i++) {
+		vector<Event> unavailabilities;
+		for (int u = unavailabilitiesStart[i]; u < unavailabilitiesStart[i + 1]; u++)
+			unavailabilities.emplace_back(UnpackDate(startDate[u]), UnpackTime(startTime[u]), UnpackDate(endDate[u]), UnpackTime(endTime[u]));
+		in.tables->referees.emplace_back(code[i], level[i], Coordinates2D(x[i], y[i]), experience[i],
+			vector<int>(incompatibleReferees + incompatibleRefereesStart[i], incompatibleReferees + incompatibleRefereesStart[i + 1]),
+			vector<int>(incompatibleTeams + incompatibleTeamsStart[i], incompatibleTeams + incompatibleTeamsStart[i + 1]),
+			unavailabilities);
+	}
+
+	// ARENAS
+	code = r.Get<int32_t>(A);
+	x = r.Get<double>(A);
+	y = r.Get<double>(A);
+	in.tables->arenas.reserve(A);
+	for (int a = 0; a < A; a++)
+		in.tables->arenas.emplace_back(code[a], Coordinates2D(x[a], y[a]));
+
+	// TEAMS
+	code = r.Get<int32_t>(T);
+	const int32_t *division = r.GetIndices(T, 1, D, "divisions of the teams");
+	in.tables->teams.reserve(T);
+	for (int t = 0; t < T; t++)
+		in.tables->teams.emplace_back(code[t], division[t]);
+
+	// GAMES
+	const int32_t *homeTeam = r.GetIndices(G, 1, T, "teams of the games"), *awayTeam = r.GetIndices(G, 1, T, "teams of the games");
+	division = r.GetIndices(G, 1, D, "divisions of the games");
+	const int32_t *arena = r.GetIndices(G, 1, A, "arenas of the games");
+	experience = r.Get<int32_t>(G);
+	startDate = r.Get<int32_t>(G);
+	startTime = r.Get<int32_t>(G);
+	endDate = r.Get<int32_t>(G);
+	endTime = r.Get<int32_t>(G);
+	in.games.reserve(G);
+	for (int g = 0; g < G; g++)
+		in.games.emplace_back(homeTeam[g], awayTeam[g], division[g],
+			Event(UnpackDate(startDate[g]), UnpackTime(startTime[g]), UnpackDate(endDate[g]), UnpackTime(endTime[g])),
+			arena[g], experience[g]);
+
+	// INDICES
+	const int32_t *firstGameOfDate = r.Get<int32_t>(header.numDates + 1);
+	if (firstGameOfDate[0] != 1 || firstGameOfDate[header.numDates] != G + 1)
+		r.Reject("first games of the dates");
+	for (int d = 0; d < header.numDates; d++)
+		if (firstGameOfDate[d] >= firstGameOfDate[d + 1])
+			r.Reject("first games of the dates");
+	const int32_t *gameDate = r.GetIndices(G, 1, header.numDates, "dates of the games");
+	const int32_t *teamGamesStart = r.GetOffsets(T, 2 * G, "games of the teams"), *teamGames = r.GetIndices(2 * G, 1, G, "games of the teams");
+	in.firstGameOfDate.assign(firstGameOfDate, firstGameOfDate + header.numDates + 1);
+	in.gameDate.assign(gameDate, gameDate + G);
+	in.teamGames.resize(T);
+	for (int t = 0; t < T; t++)
+		in.teamGames[t].assign(teamGames + teamGamesStart[t], teamGames + teamGamesStart[t + 1]);
+
+	munmap(mapping, st.st_size);
+	close(fd);
+
+	in.BuildIncompatibilities();
+	in.BuildPairGames();
+}
@@ -0,0 +1,43 @@
+// File RA_Binary.hh
+
+#ifndef RA_BINARY_HH
+#define RA_BINARY_HH
+
+#include <string>
+#include <cstdint>
+#include "RA_Data.hh"
+
+using namespace std;
+
+/*	Binary instance format, read by mapping the file in memory: a header
+	followed by the arrays of each field (structure of arrays), each one
+	aligned to 8 bytes. The games are stored sorted, together with the
+	indices RA_Input builds on them, the variable-length lists (incompatible
+	referees, incompatible teams, unavailabilities, games of each team) as an
+	array of offsets and an array of values. The dates are stored as
+	yyyymmdd and the times in minutes from midnight.
+	The weights are not part of the instance (as in the text format).
+*/
+class RA_BinaryInstance {
+
+public:
+	static const char magic[8];
+	static const uint32_t version = 1;
+
+	static bool IsBinary(const string& fileName);	// true if the file starts with the magic string
+	static void Read(const string& fileName, RA_Input& in);
+	static void Write(const RA_Input& in, const string& fileName);
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;	// 0x01020304 in the byte order of the writer
+		uint64_t fileSize;
+		int32_t numDivisions, numReferees, numArenas, numTeams, numGames, numDates;
+		int32_t numIncompatibleReferees, numIncompatibleTeams, numUnavailabilities;
+		int32_t reserved;
+	};
+
+};
+
+#endif
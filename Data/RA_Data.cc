@@ -5,16 +5,28 @@
 #include <algorithm>
 #include <cmath>
 #include "RA_Data.hh"
+#include "RA_Binary.hh"
+#include "RA_Parser.hh"
 #include "Event.hh"
 #include "Coordinates2D.hh"
 
-RA_Input::RA_Input(string fileName) {
-	ifstream is(fileName);
-	if (!is) {
-		cerr << "Cannot open file " << fileName << endl;
+RA_Input::RA_Input(string fileName) : tables(make_shared<RA_InputTables>()) {
+	if (RA_BinaryInstance::IsBinary(fileName))
+		RA_BinaryInstance::Read(fileName, *this);
+	else
+		RA_TextParser(fileName).Parse(*this);
+}
+
+RA_Input ReadInstance(const string& fileName) {
+	try {
+		return RA_Input(fileName);
+	} catch (const RA_ParseError& e) {
+		cerr << e.what() << endl;
 		exit(1);
 	}
+}
 
+RA_Input::RA_Input(istream& is) : tables(make_shared<RA_InputTables>()) {
 	string s;
 
 	is >> s >> s >> numDivisions >> s;
@@ -22,35 +34,35 @@ RA_Input::RA_Input(string fileName) {
 	is >> s >> s >> numArenas >> s;
 	is >> s >> s >> numTeams >> s;
 	is >> s >> s >> numGames >> s;
-	divisions.resize(numDivisions);
-	referees.resize(numReferees);
-	arenas.resize(numArenas);
-	teams.resize(numTeams);
+	tables->divisions.resize(numDivisions);
+	tables->referees.resize(numReferees);
+	tables->arenas.resize(numArenas);
+	tables->teams.resize(numTeams);
 	games.resize(numGames);
 
 	// DIVISIONS
 	is >> s;
 	getline(is, s);
 	for (int i = 0; i < numDivisions; i++)
-		is >> divisions[i];
+		is >> tables->divisions[i];
 
 	// REFEREES
 	is >> s;
 	getline(is, s);
 	for (int i = 0; i < numReferees; i++)
-		is >> referees[i];
+		is >> tables->referees[i];
 
 	// ARENAS
 	is >> s;
 	getline(is, s);
 	for (int i = 0; i < numArenas; i++)
-		is >> arenas[i];
+		is >> tables->arenas[i];
 
 	// TEAMS
 	is >> s;
 	getline(is, s);
 	for (int i = 0; i < numTeams; i++)
-		is >> teams[i];
+		is >> tables->teams[i];
 
 	// GAMES
 	is >> s;
@@ -59,6 +71,83 @@ RA_Input::RA_Input(string fileName) {
 		is >> games[i];
 
 	sort(games.begin(), games.end(), less_equal<Game>());
+
+	BuildIndices();
+}
+
+RA_Input::RA_Input(const RA_Input& in, int firstGame, int lastGame)
+	: numDivisions(in.numDivisions), numReferees(in.numReferees), numArenas(in.numArenas), numTeams(in.numTeams), numGames(lastGame - firstGame),
+	  tables(in.tables),
+	  games(in.games.begin() + (firstGame - 1), in.games.begin() + (lastGame - 1)),
+	  lackOfExperienceWeight(in.lackOfExperienceWeight), gamesDistributionWeight(in.gamesDistributionWeight),
+	  totalDistanceWeight(in.totalDistanceWeight), optionalRefereeWeight(in.optionalRefereeWeight),
+	  assignmentFrequencyWeight(in.assignmentFrequencyWeight), refereeIncompatibilityWeight(in.refereeIncompatibilityWeight),
+	  teamIncompatibilityWeight(in.teamIncompatibilityWeight) {
+	BuildIndices(false);
+}
+
+void RA_Input::BuildIndices(bool incompatibilities) {
+	teamGames.resize(numTeams);
+	for (int g = 1; g <= numGames; g++) {
+		teamGames[GetGame(g).HomeTeam() - 1].push_back(g);
+		teamGames[GetGame(g).AwayTeam() - 1].push_back(g);
+		if (g == 1 || GetGame(g).Match().StartDate() != GetGame(g - 1).Match().StartDate())
+			firstGameOfDate.push_back(g);
+	}
+	firstGameOfDate.push_back(numGames + 1);
+
+	gameDate.resize(numGames);
+	for (int d = 1; d <= NumDates(); d++)
+		for (int g = FirstGameOfDate(d); g < FirstGameOfDate(d + 1); g++)
+			gameDate[g - 1] = d;
+
+	if (incompatibilities)
+		BuildIncompatibilities();
+	BuildPairGames();
+}
+
+void RA_Input::BuildPairGames() {
+	pairGames.clear();
+	pairGames.reserve(numGames);
+	for (int g = 1; g <= numGames; g++)
+		pairGames[static_cast<long long>(GetGame(g).HomeTeam() - 1) * numTeams + GetGame(g).AwayTeam() - 1].push_back(g);
+}
+
+const vector<int>& RA_Input::PairGames(int homeTeam, int awayTeam) const {
+	static const vector<int> noGames;
+
+	if (homeTeam < 1 || homeTeam > numTeams || awayTeam < 1 || awayTeam > numTeams)
+		return noGames;
+
+	unordered_map<long long, vector<int>>::const_iterator it = pairGames.find(static_cast<long long>(homeTeam - 1) * numTeams + awayTeam - 1);
+
+	return it == pairGames.end() ? noGames : it->second;
+}
+
+int RA_Input::FindGame(int homeTeam, int awayTeam) const {
+	const vector<int>& g = PairGames(homeTeam, awayTeam);
+
+	return g.empty() ? 0 : g.front();
+}
+
+int RA_Input::FindGame(int homeTeam, int awayTeam, const Date& date) const {
+	for (int g : PairGames(homeTeam, awayTeam))
+		if (GetGame(g).Match().StartDate() == date)
+			return g;
+
+	return 0;
+}
+
+void RA_Input::BuildIncompatibilities() {
+	vector<vector<int>> incompatibleReferees(numReferees), incompatibleTeams(numTeams);
+	for (int r = 1; r <= numReferees; r++) {
+		incompatibleReferees[r - 1] = GetReferee(r).IncompatibleReferees();
+		for (int t : GetReferee(r).IncompatibleTeams())
+			if (t >= 1 && t <= numTeams)
+				incompatibleTeams[t - 1].push_back(r);
+	}
+	tables->refereeIncompatibilities = IncompatibilityMatrix(numReferees, numReferees, incompatibleReferees);
+	tables->teamIncompatibilities = IncompatibilityMatrix(numTeams, numReferees, incompatibleTeams);
 }
 
 ostream& operator<<(ostream& os, const RA_Input& ra) {
@@ -72,25 +161,25 @@ ostream& operator<<(ostream& os, const RA_Input& ra) {
 	os << endl;
 	os << "DIVISIONS % code, min referees, max referees, level, teams" << endl;
 	for (int i = 0; i < ra.numDivisions; i++)
-		os << ra.divisions[i] << endl;
+		os << ra.tables->divisions[i] << endl;
 
 	// REFEREES
 	os << endl;
 	os << "REFEREES % code, level, coordinates, experience, incompatible referees, incompatible teams, unavailabilities" << endl;
 	for (int i = 0; i < ra.numReferees; i++)
-		os << ra.referees[i] << endl;
+		os << ra.tables->referees[i] << endl;
 
 	// ARENAS
 	os << endl;
 	os << "ARENAS % code, coordinates" << endl;
 	for (int i = 0; i < ra.numArenas; i++)
-		os << ra.arenas[i] << endl;
+		os << ra.tables->arenas[i] << endl;
 
 	// TEAMS
 	os << endl;
 	os << "TEAMS % name, division" << endl;
 	for (int i = 0; i < ra.numTeams; i++)
-		os << ra.teams[i] << endl;
+		os << ra.tables->teams[i] << endl;
 
 	// GAMES
 	os << endl;
@@ -119,12 +208,14 @@ ostream& operator<<(ostream& os, const RA_Input& ra) {
 }
 
 RA_Output::RA_Output(const RA_Input& i)
-	: in(i), games(in.NumGames(), set<int>()), referees(in.NumReferees(), set<int>())
+	: in(i), games(in.NumGames(), set<int>()), referees(in.NumReferees(), set<int>()), totalAssignments(0), refereeLoads(1, in.NumReferees())
 {}
 
 RA_Output& RA_Output::operator=(const RA_Output& out) {
 	games = out.games;
 	referees = out.referees;
+	totalAssignments = out.totalAssignments;
+	refereeLoads = out.refereeLoads;
 	return *this;
 }
 
@@ -134,6 +225,9 @@ void RA_Output::Reset() {
 
 	for (long unsigned int i = 0; i < referees.size(); i++)
 		referees[i].clear();
+
+	totalAssignments = 0;
+	refereeLoads.assign(1, in.NumReferees());
 }
 
 bool RA_Output::HasMinimumReferees(int g) const {
@@ -211,13 +305,8 @@ bool RA_Output::LackOfExperience(int g) const {
 }
 
 int RA_Output::GamesDistribution(int r) const {
-	int totalAssignedGames = 0;
-	double averageAssignedGames;
-
-	for (int ref = 1; ref <= in.NumReferees(); ref++)
-		totalAssignedGames += AssignedGames(ref).size();
+	double averageAssignedGames = static_cast<double>(totalAssignments) / in.NumReferees();
 
-	averageAssignedGames = static_cast<double>(totalAssignedGames) / in.NumReferees();
 	return static_cast<int>(ceil(fabs(averageAssignedGames - AssignedGames(r).size())));
 }
 
@@ -287,49 +376,38 @@ int RA_Output::AssignmentFrequency(int r, int t) const {
 }
 
 int RA_Output::RefereeIncompatibility(int g) const {
-	int refereeIncompatibility = 0;
-
-	if (AssignedReferees(g).size() >= 2) {
-		for (set<int>::iterator itI = AssignedReferees(g).begin(); itI != prev(AssignedReferees(g).end()); ++itI)
-			for (set<int>::iterator itJ = next(itI); itJ != AssignedReferees(g).end(); ++itJ) {
-				const Referee &refereeI = in.GetReferee(*itI);
-				const Referee &refereeJ = in.GetReferee(*itJ);
-				
-				if (refereeI.IncompatibleReferee(refereeJ.Code()))
-					refereeIncompatibility++;
-
-				if (refereeJ.IncompatibleReferee(refereeI.Code()))
-					refereeIncompatibility++;
-			}
-	}
-	return refereeIncompatibility;
+	return in.RefereeIncompatibilities().CountPairs(AssignedReferees(g));
 }
 
 int RA_Output::TeamIncompatibility(int g) const {
-	int teamIncompatibility = 0;
-	const Team &homeTeam = in.GetTeam(in.GetGame(g).HomeTeam());
-	const Team &awayTeam = in.GetTeam(in.GetGame(g).AwayTeam());
-
-	for (set<int>::iterator it = AssignedReferees(g).begin(); it != AssignedReferees(g).end(); ++it) {
-		const Referee &referee = in.GetReferee(*it);
+	const Game &game = in.GetGame(g);
 
-		if (referee.IncompatibleTeam(homeTeam.Code()))
-			teamIncompatibility++;
-
-		if (referee.IncompatibleTeam(awayTeam.Code()))
-			teamIncompatibility++;
-	}
-	return teamIncompatibility;
+	return in.TeamIncompatibilities().Count(game.HomeTeam(), AssignedReferees(g))
+		+ in.TeamIncompatibilities().Count(game.AwayTeam(), AssignedReferees(g));
 }
 
 void RA_Output::Assign(int r, int g) {
-	referees[r - 1].insert(g);
+	if (!referees[r - 1].insert(g).second)
+		return;
 	games[g - 1].insert(r);
+
+	int load = referees[r - 1].size();
+	if (load == static_cast<int>(refereeLoads.size()))
+		refereeLoads.push_back(0);
+	refereeLoads[load - 1]--;
+	refereeLoads[load]++;
+	totalAssignments++;
 }
 
 void RA_Output::Unassign(int r, int g) {
-	referees[r - 1].erase(g);
+	if (referees[r - 1].erase(g) == 0)
+		return;
 	games[g - 1].erase(r);
+
+	int load = referees[r - 1].size();
+	refereeLoads[load + 1]--;
+	refereeLoads[load]++;
+	totalAssignments--;
 }
 
 void RA_Output::UnassignAll(int g) {
@@ -458,48 +536,107 @@ ostream& operator<<(ostream& os, const RA_Output& out) {
 	while (referees /= 10)
 		digitsReferee++;
 
+	// the lines are formatted in one buffer, written at once
+	size_t assignments = 0;
+	for (long unsigned int g = 1; g <= out.games.size(); g++)
+		assignments += out.AssignedReferees(g).size();
+
+	string buffer;
+	buffer.reserve(out.games.size() * (2 * (digitsTeam + 2) + digitsAssignedReferees + 2) + assignments * (digitsReferee + 2));
+
+	// the value (with the prefix, if any) right aligned in width characters, followed by a space
+	auto Append = [&buffer](char prefix, int value, int width) {
+		char field[16];
+		char *begin = field + sizeof(field);
+
+		do {
+			*--begin = '0' + value % 10;
+			value /= 10;
+		} while (value > 0);
+		if (prefix != '\0')
+			*--begin = prefix;
+		if (field + sizeof(field) - begin < width)
+			buffer.append(width - (field + sizeof(field) - begin), ' ');
+		buffer.append(begin, field + sizeof(field));
+		buffer.push_back(' ');
+	};
+
 	for (long unsigned int g = 1; g <= out.games.size(); g++) {
-		os.width(digitsTeam + 1); os.fill(' ');
-		os << right << "T" + to_string(out.in.GetTeam(out.in.GetGame(g).HomeTeam()).Code()) << " ";
-		os.width(digitsTeam + 1); os.fill(' ');
-		os << right << "T" + to_string(out.in.GetTeam(out.in.GetGame(g).AwayTeam()).Code()) << " ";
-		os.width(digitsAssignedReferees); os.fill(' ');
-		os << right << out.AssignedReferees(g).size() << " ";
-
-		for (set<int>::iterator it = out.AssignedReferees(g).begin(); it != out.AssignedReferees(g).end(); ++it) {
-			os.width(digitsReferee + 1); os.fill(' ');
-			os << right << "R" + to_string(out.in.GetReferee(*it).Code()) << " ";
-		}
+		Append('T', out.in.GetTeam(out.in.GetGame(g).HomeTeam()).Code(), digitsTeam + 1);
+		Append('T', out.in.GetTeam(out.in.GetGame(g).AwayTeam()).Code(), digitsTeam + 1);
+		Append('\0', out.AssignedReferees(g).size(), digitsAssignedReferees);
 
-		os << endl;
+		for (int r : out.AssignedReferees(g))
+			Append('R', out.in.GetReferee(r).Code(), digitsReferee + 1);
+
+		buffer.push_back('\n');
 	}
 
+	os.write(buffer.data(), buffer.size());
+
 	return os;
 }
 
+/*	Reads one game per line (as written by operator<<), each one found by
+	the index of the games between two teams: the games of the same pair
+	are taken in order. Unknown games or referees, games read twice and
+	missing lines throw a RA_ParseError ("solution:line:column: ...").
+*/
 istream& operator>>(istream& is, RA_Output& out) {
-	int homeTeam, awayTeam, assignedReferees, referee, i, hT, aT;
-	char ch;
+	string line;
+	int lineNumber = 0;
+	vector<bool> read(out.games.size() + 1, false);
 
 	out.Reset();
 
-	for (long unsigned int g = 1; g <= out.games.size(); g++) {
-		is >> ch >> homeTeam >> ch >> awayTeam;
-
-		for (i = 1; i <= out.in.NumGames(); i++) {
-			const Game &game = out.in.GetGame(i);
-			hT = out.in.GetTeam(game.HomeTeam()).Code();
-			aT = out.in.GetTeam(game.AwayTeam()).Code();
-
-			if (homeTeam == hT && awayTeam == aT)
+	for (long unsigned int n = 1; n <= out.games.size(); n++) {
+		const char *p;
+		int homeTeam, awayTeam, assignedReferees, column, g = 0;
+
+		do {
+			if (!getline(is, line))
+				throw RA_ParseError("solution", lineNumber + 1, 1, "expected " + to_string(out.games.size()) + " games, found " + to_string(n - 1));
+			lineNumber++;
+			p = line.c_str();
+			while (*p == ' ' || *p == '\t' || *p == '\r')
+				p++;
+		} while (*p == '\0');
+
+		// an optional prefix character (T or R) followed by a non-negative integer
+		auto Number = [&](char prefix) {
+			int value = 0;
+
+			while (*p == ' ' || *p == '\t')
+				p++;
+			column = static_cast<int>(p - line.c_str()) + 1;
+			if (prefix != '\0' && *p == prefix)
+				p++;
+			if (*p < '0' || *p > '9')
+				throw RA_ParseError("solution", lineNumber, column, prefix != '\0' ? string("expected a code ") + prefix + "<number>" : "expected an integer");
+			while (*p >= '0' && *p <= '9')
+				value = value * 10 + (*p++ - '0');
+			return value;
+		};
+
+		homeTeam = Number('T');
+		awayTeam = Number('T');
+		for (int i : out.in.PairGames(homeTeam, awayTeam))
+			if (!read[i]) {
+				g = i;
 				break;
-		}
-
-		is >> assignedReferees;
+			}
+		if (g == 0)
+			throw RA_ParseError("solution", lineNumber, 1, "unknown game T" + to_string(homeTeam) + " T" + to_string(awayTeam)
+			                    + (out.in.FindGame(homeTeam, awayTeam) != 0 ? " (read twice)" : ""));
+		read[g] = true;
 
+		assignedReferees = Number('\0');
 		for (int j = 0; j < assignedReferees; j++) {
-			is >> ch >> referee;
-			out.Assign(referee, i);
+			int referee = Number('R');
+
+			if (referee < 1 || referee > out.in.NumReferees())
+				throw RA_ParseError("solution", lineNumber, column, "unknown referee R" + to_string(referee));
+			out.Assign(referee, g);
 		}
 	}
 
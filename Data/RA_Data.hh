@@ -6,30 +6,58 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include "Division.hh"
 #include "Referee.hh"
 #include "Arena.hh"
 #include "Team.hh"
 #include "Game.hh"
+#include "IncompatibilityMatrix.hh"
 
 using namespace std;
 
+/*	The tables of an instance that do not depend on its games, shared (and
+	never modified once read) by the instance and its sub-instances.
+*/
+struct RA_InputTables {
+	vector<Division> divisions;
+	vector<Referee> referees;
+	vector<Arena> arenas;
+	vector<Team> teams;
+	IncompatibilityMatrix refereeIncompatibilities;
+	IncompatibilityMatrix teamIncompatibilities;
+};
+
 class RA_Input {
 
 	friend ostream& operator<<(ostream& os, const RA_Input& ra);
+	friend class RA_BinaryInstance;
+	friend class RA_TextParser;
 
 public:
-	RA_Input(string fileName);
+	RA_Input(string fileName);	// text (see RA_Parser.hh, throws RA_ParseError) or binary (see RA_Binary.hh) instance
+	RA_Input(istream& is);	// text instance read by the extractors of the classes, without any check
+	RA_Input(const RA_Input& in, int firstGame, int lastGame);	// sub-instance made of the games [firstGame, lastGame) of in, sharing its other tables
 	int NumDivisions() const { return numDivisions; }
 	int NumReferees() const { return numReferees; }
 	int NumArenas() const { return numArenas; }
 	int NumTeams() const { return numTeams; }
 	int NumGames() const { return numGames; }
-	const Division& GetDivision(int d) const { return divisions[d - 1]; }
-	const Referee& GetReferee(int r) const { return referees[r - 1]; }
-	const Arena& GetArena(int a) const { return arenas[a - 1]; }
-	const Team& GetTeam(int t) const { return teams[t - 1]; }
+	const Division& GetDivision(int d) const { return tables->divisions[d - 1]; }
+	const Referee& GetReferee(int r) const { return tables->referees[r - 1]; }
+	const Arena& GetArena(int a) const { return tables->arenas[a - 1]; }
+	const Team& GetTeam(int t) const { return tables->teams[t - 1]; }
 	const Game& GetGame(int g) const { return games[g - 1]; }
+	const vector<int>& TeamGames(int t) const { return teamGames[t - 1]; }	// returns the (sorted) games played by the team
+	int NumDates() const { return static_cast<int>(firstGameOfDate.size()) - 1; }	// number of distinct dates of the games
+	int FirstGameOfDate(int d) const { return firstGameOfDate[d - 1]; }	// the games of the date d are [FirstGameOfDate(d), FirstGameOfDate(d + 1)), for d = NumDates() + 1 returns NumGames() + 1
+	int DateOf(int g) const { return gameDate[g - 1]; }	// the date d of the game, i.e. FirstGameOfDate(d) <= g < FirstGameOfDate(d + 1)
+	const vector<int>& PairGames(int homeTeam, int awayTeam) const;	// returns the (sorted) games between the two teams, at home of the first one
+	int FindGame(int homeTeam, int awayTeam) const;	// returns the first game between the two teams (0 if none)
+	int FindGame(int homeTeam, int awayTeam, const Date& date) const;	// returns the game between the two teams starting at the date (0 if none)
+	const IncompatibilityMatrix& RefereeIncompatibilities() const { return tables->refereeIncompatibilities; }	// (r1, r2): the referee r1 is incompatible with the referee r2
+	const IncompatibilityMatrix& TeamIncompatibilities() const { return tables->teamIncompatibilities; }	// (t, r): the referee r is incompatible with the team t
 	int LackOfExperienceWeight() const { return lackOfExperienceWeight; }
 	int GamesDistributionWeight() const { return gamesDistributionWeight; }
 	int TotalDistanceWeight() const { return totalDistanceWeight; }
@@ -46,16 +74,21 @@ public:
 	void SetTeamIncompatibilityWeight(int ti) { teamIncompatibilityWeight = ti; }
 
 private:
+	void BuildIndices(bool incompatibilities = true);	// the incompatibility matrices are shared by the sub-instances
+	void BuildIncompatibilities();
+	void BuildPairGames();
+
 	int numDivisions;
 	int numReferees;
 	int numArenas;
 	int numTeams;
 	int numGames;
-	vector<Division> divisions;
-	vector<Referee> referees;
-	vector<Arena> arenas;
-	vector<Team> teams;
+	shared_ptr<RA_InputTables> tables;
 	vector<Game> games;
+	vector<vector<int>> teamGames;
+	vector<int> firstGameOfDate;
+	vector<int> gameDate;
+	unordered_map<long long, vector<int>> pairGames;	// key (homeTeam - 1) * numTeams + awayTeam - 1
 
 	// Soft constraints weights
 	int lackOfExperienceWeight = 1;
@@ -68,6 +101,8 @@ private:
 
 };
 
+RA_Input ReadInstance(const string& fileName);	// RA_Input(fileName) for the drivers: on a RA_ParseError prints it and exits with 1
+
 class RA_Output {
 
 	friend ostream& operator<<(ostream& os, const RA_Output& out);
@@ -87,6 +122,8 @@ public:
 	void SetAverageSpeed(int s) { averageSpeed = s; }
 	const set<int>& AssignedReferees(int g) const { return games[g - 1]; }	// returns the set of referees assigned to the game
 	const set<int>& AssignedGames(int r) const { return referees[r - 1]; }	// returns the set of games assigned to the referee
+	int TotalAssignments() const { return totalAssignments; }	// returns the number of (referee, game) assignments
+	const vector<int>& RefereeLoads() const { return refereeLoads; }	// returns, for each n, the number of referees with n assigned games
 	bool OverlappingGames(const Game& previousGame, const Game& nextGame, int r) const;	// returns true if the two games overlap in time; the notion of overlapping considers also the travel time of the referee between the two arenas
 	// HARD CONSTRAINTS
 	bool HasMinimumReferees(int g) const;	// returns true if the number of mandatory referees is assigned to the game
@@ -109,6 +146,8 @@ protected:
 	const RA_Input& in;
 	vector<set<int>> games;
 	vector<set<int>> referees;
+	int totalAssignments;
+	vector<int> refereeLoads;	// kept by Assign and Unassign, so that the average number of assigned games is known in O(1)
 	int averageSpeed = 50; // km/h
 
 };
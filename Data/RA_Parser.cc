@@ -0,0 +1,400 @@
+// File RA_Parser.cc
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <climits>
+#include <locale>
+#include "RA_Parser.hh"
+
+RA_ParseError::RA_ParseError(const string& fileName, int l, int c, const string& message)
+	: runtime_error(l == 0 ? fileName + ": " + message
+	                       : fileName + ":" + to_string(l) + ":" + to_string(c) + ": " + message),
+	  line(l), column(c) {}
+
+RA_TextParser::RA_TextParser(const string& fileName) : name(fileName) {
+	ifstream is(fileName, ios::binary);
+	ostringstream buffer;
+
+	if (!is)
+		throw RA_ParseError(fileName, 0, 0, "cannot open file");
+
+	buffer << is.rdbuf();
+	text = buffer.str();
+	p = token = text.c_str();
+}
+
+RA_TextParser::RA_TextParser(const string& n, const string& t) : name(n), text(t) {
+	p = token = text.c_str();
+}
+
+void RA_TextParser::Parse(RA_Input& in) {
+	in.numDivisions = Count("Divisions");
+	in.numReferees = Count("Referees");
+	in.numArenas = Count("Arenas");
+	in.numTeams = Count("Teams");
+	in.numGames = Count("Games");
+	in.tables->divisions.reserve(in.numDivisions);
+	in.tables->referees.reserve(in.numReferees);
+	in.tables->arenas.reserve(in.numArenas);
+	in.tables->teams.reserve(in.numTeams);
+	in.games.reserve(in.numGames);
+
+	// DIVISIONS
+	Section("DIVISIONS");
+	for (int i = 1; i <= in.numDivisions; i++) {
+		int code, minReferees, maxReferees, level, teams;
+
+		if ((code = Code('D', in.numDivisions)) != i)
+			Error("expected division D" + to_string(i));
+		Expect(':');
+		minReferees = Integer();
+		Expect(',');
+		maxReferees = Integer();
+		Expect(',');
+		level = Integer();
+		Expect(',');
+		teams = Integer();
+		if (minReferees < 0 || maxReferees < minReferees)
+			Error("invalid number of referees of division D" + to_string(code));
+		in.tables->divisions.emplace_back(code, minReferees, maxReferees, level, teams);
+	}
+
+	// REFEREES
+	Section("REFEREES");
+	for (int i = 1; i <= in.numReferees; i++) {
+		int code, level, experience;
+		Coordinates2D address;
+		vector<int> incompatibleReferees, incompatibleTeams;
+		vector<Event> unavailabilities;
+
+		if ((code = Code('R', in.numReferees)) != i)
+			Error("expected referee R" + to_string(i));
+		Expect(',');
+		level = Integer();
+		Expect(',');
+		address = ParseCoordinates();
+		Expect(',');
+		experience = Integer();
+		Expect(',');
+
+		// the code 0 (no referee or team, e.g. T0 in RA-5-50) is accepted in the incompatibilities
+		Expect('[');
+		if (Peek() != ']')
+			for (;;) {
+				incompatibleReferees.push_back(Code('R', in.numReferees, 0));
+				if (Peek() != ',')
+					break;
+				Expect(',');
+			}
+		Expect(']');
+		Expect(',');
+
+		Expect('[');
+		if (Peek() != ']')
+			for (;;) {
+				incompatibleTeams.push_back(Code('T', in.numTeams, 0));
+				if (Peek() != ',')
+					break;
+				Expect(',');
+			}
+		Expect(']');
+		Expect(',');
+
+		Expect('[');
+		if (Peek() != ']')
+			for (;;) {
+				unavailabilities.push_back(ParseEvent());
+				if (Peek() != ',')
+					break;
+				Expect(',');
+			}
+		Expect(']');
+
+		sort(incompatibleReferees.begin(), incompatibleReferees.end());
+		sort(incompatibleTeams.begin(), incompatibleTeams.end());
+		sort(unavailabilities.begin(), unavailabilities.end(), less_equal<Event>());
+		in.tables->referees.emplace_back(code, level, address, experience, incompatibleReferees, incompatibleTeams, unavailabilities);
+	}
+
+	// ARENAS
+	Section("ARENAS");
+	for (int i = 1; i <= in.numArenas; i++) {
+		int code;
+
+		if ((code = Code('A', in.numArenas)) != i)
+			Error("expected arena A" + to_string(i));
+		in.tables->arenas.emplace_back(code, ParseCoordinates());
+	}
+
+	// TEAMS
+	Section("TEAMS");
+	for (int i = 1; i <= in.numTeams; i++) {
+		int code;
+
+		if ((code = Code('T', in.numTeams)) != i)
+			Error("expected team T" + to_string(i));
+		in.tables->teams.emplace_back(code, Code('D', in.numDivisions));
+	}
+
+	// GAMES
+	Section("GAMES");
+	for (int i = 1; i <= in.numGames; i++) {
+		int homeTeam = Code('T', in.numTeams), awayTeam = Code('T', in.numTeams), division = Code('D', in.numDivisions);
+		Event match = ParseEvent();
+		int arena = Code('A', in.numArenas);
+
+		in.games.emplace_back(homeTeam, awayTeam, division, match, arena, Integer());
+	}
+
+	if (Peek() != '\0')
+		Error("unexpected text after the last game");
+
+	sort(in.games.begin(), in.games.end(), less_equal<Game>());
+
+	in.BuildIndices();
+}
+
+void RA_TextParser::SkipSpaces() {
+	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+		p++;
+	token = p;
+}
+
+void RA_TextParser::SkipLine() {
+	while (*p != '\0' && *p != '\n')
+		p++;
+}
+
+char RA_TextParser::Peek() {
+	SkipSpaces();
+	return *p;
+}
+
+void RA_TextParser::Expect(char c) {
+	if (Peek() != c)
+		Error(string("expected '") + c + "'");
+	p++;
+}
+
+void RA_TextParser::ExpectWord(const string& word) {
+	SkipSpaces();
+	if (text.compare(p - text.c_str(), word.size(), word) != 0)
+		Error("expected " + word);
+	p += word.size();
+}
+
+int RA_TextParser::Integer() {
+	bool negative = false;
+	long value = 0;
+
+	SkipSpaces();
+	if (*p == '-') {
+		negative = true;
+		p++;
+	}
+	if (*p < '0' || *p > '9')
+		Error("expected an integer");
+	while (*p >= '0' && *p <= '9') {
+		value = value * 10 + (*p - '0');
+		if (value > INT_MAX)
+			Error("integer out of range");
+		p++;
+	}
+
+	return static_cast<int>(negative ? -value : value);
+}
+
+/*	The digits are accumulated in an integer mantissa with a decimal
+	exponent; when the mantissa has at most 53 bits and the exponent is
+	within the exact powers of ten, a single multiplication or division
+	gives the correctly rounded value (as strtod), otherwise the number is
+	converted by a stream in the classic locale.
+*/
+double RA_TextParser::Real() {
+	static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	const char *start;
+	bool negative = false, digits = false, exact = true;
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	double value;
+
+	SkipSpaces();
+	start = p;
+	if (*p == '-' || *p == '+')
+		negative = *p++ == '-';
+	for (bool fraction = false; (*p >= '0' && *p <= '9') || (*p == '.' && !fraction); p++) {
+		if (*p == '.') {
+			fraction = true;
+			continue;
+		}
+		digits = true;
+		if (mantissa < 100000000000000000ULL) {
+			mantissa = mantissa * 10 + (*p - '0');
+			exponent -= fraction;
+		} else {
+			exact = false;
+			exponent += !fraction;
+		}
+	}
+	if (!digits)
+		Error("expected a number");
+	if ((*p == 'e' || *p == 'E') && ((p[1] >= '0' && p[1] <= '9') || ((p[1] == '-' || p[1] == '+') && p[2] >= '0' && p[2] <= '9'))) {
+		bool negativeExponent = *++p == '-';
+		int e = 0;
+
+		if (*p == '-' || *p == '+')
+			p++;
+		for (; *p >= '0' && *p <= '9'; p++)
+			e = min(e * 10 + (*p - '0'), 100000);
+		exponent += negativeExponent ? -e : e;
+	}
+
+	if (exact && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+		value = exponent >= 0 ? mantissa * powersOf10[exponent] : mantissa / powersOf10[-exponent];
+	else {
+		istringstream is(string(start, p));
+
+		is.imbue(locale::classic());
+		is >> value;
+		return value;
+	}
+
+	return negative ? -value : value;
+}
+
+int RA_TextParser::Code(char prefix, int count, int first) {
+	int code;
+
+	Expect(prefix);
+	if (*p < '0' || *p > '9')
+		Error(string("expected a code ") + prefix + "<number>");
+	code = Integer();
+	if (code < first || code > count)
+		Error(string(1, prefix) + to_string(code) + " out of range (" + to_string(count) + " declared)");
+
+	return code;
+}
+
+int RA_TextParser::Count(const string& what) {
+	int count;
+
+	ExpectWord(what);
+	Expect('=');
+	count = Integer();
+	if (count < 0)
+		Error("negative number of " + what);
+	Expect(';');
+
+	return count;
+}
+
+void RA_TextParser::Section(const string& what) {
+	ExpectWord(what);
+	SkipLine();
+}
+
+Date RA_TextParser::ParseDate() {
+	const char *start;
+	int day, month, year;
+
+	SkipSpaces();
+	start = p;
+	day = Integer();
+	Expect('/');
+	month = Integer();
+	Expect('/');
+	year = Integer();
+
+	Date date(day, month, year);
+	// an invalid date is turned into 1/1/1
+	if (date.Day() != day || date.Month() != month || date.Year() != year) {
+		token = start;
+		Error("invalid date");
+	}
+
+	return date;
+}
+
+Time RA_TextParser::ParseTime() {
+	const char *start;
+	int hours, minutes;
+
+	SkipSpaces();
+	start = p;
+	hours = Integer();
+	Expect(':');
+	minutes = Integer();
+
+	Time time(hours, minutes);
+	// an invalid time is turned into 00:00
+	if (time.Hours() != hours || time.Minutes() != minutes) {
+		token = start;
+		Error("invalid time");
+	}
+
+	return time;
+}
+
+/*	date time (two hours long), date time-time or date time~date time; as in
+	the extractor the separator must follow the time immediately.
+*/
+Event RA_TextParser::ParseEvent() {
+	const char *start;
+	Date startDate, endDate;
+	Time startTime, endTime;
+	Event event;
+
+	SkipSpaces();
+	start = p;
+	startDate = ParseDate();
+	startTime = ParseTime();
+
+	if (*p == '-') {
+		p++;
+		endTime = ParseTime();
+		event = Event(startDate, startTime, startDate, endTime);
+		endDate = startDate;
+	} else if (*p == '~') {
+		p++;
+		endDate = ParseDate();
+		endTime = ParseTime();
+		event = Event(startDate, startTime, endDate, endTime);
+	} else
+		return Event(startDate, startTime);
+
+	// an invalid event (ending before it starts) is turned into 1/1/1 00:00-00:01
+	if (event.StartDate() != startDate || event.EndDate() != endDate
+		|| event.StartTime().TimeInMinutes() != startTime.TimeInMinutes() || event.EndTime().TimeInMinutes() != endTime.TimeInMinutes()) {
+		token = start;
+		Error("invalid event");
+	}
+
+	return event;
+}
+
+Coordinates2D RA_TextParser::ParseCoordinates() {
+	double x, y;
+
+	Expect('(');
+	x = Real();
+	Expect(',');
+	y = Real();
+	Expect(')');
+
+	return Coordinates2D(x, y);
+}
+
+void RA_TextParser::Error(const string& message) const {
+	int line = 1, column = 1;
+
+	for (const char *c = text.c_str(); c < token; c++)
+		if (*c == '\n') {
+			line++;
+			column = 1;
+		} else
+			column++;
+
+	throw RA_ParseError(name, line, column, message + (*token == '\0' ? " (end of file)" : ""));
+}
@@ -0,0 +1,61 @@
+// File RA_Parser.hh
+
+#ifndef RA_PARSER_HH
+#define RA_PARSER_HH
+
+#include <string>
+#include <stdexcept>
+#include "RA_Data.hh"
+
+using namespace std;
+
+class RA_ParseError : public runtime_error {
+
+public:
+	RA_ParseError(const string& fileName, int l, int c, const string& message);	// l = 0: error on the whole file
+	int Line() const { return line; }
+	int Column() const { return column; }
+
+private:
+	int line;
+	int column;
+
+};
+
+/*	Single-pass parser of the text instances: the file is read in a buffer
+	and scanned once, with the numbers converted by hand (independently of
+	the locale, unlike strtod). It accepts the same grammar as the extractors of the classes,
+	but it checks it: any unexpected character, a code out of range (or not
+	in order in its own section), an invalid date, time or event is reported
+	by a RA_ParseError with its line and column.
+*/
+class RA_TextParser {
+
+public:
+	RA_TextParser(const string& fileName);	// reads the file
+	RA_TextParser(const string& name, const string& text);	// parses the text, name is used in the errors
+	void Parse(RA_Input& in);
+
+private:
+	void SkipSpaces();
+	void SkipLine();
+	char Peek();	// the next character after the spaces
+	void Expect(char c);
+	void ExpectWord(const string& word);
+	int Integer();
+	double Real();
+	int Code(char prefix, int count, int first = 1);	// e.g. R3, in [first, count]
+	int Count(const string& name);	// e.g. Referees = 5;
+	void Section(const string& name);	// e.g. REFEREES % comment
+	Date ParseDate();
+	Time ParseTime();
+	Event ParseEvent();
+	Coordinates2D ParseCoordinates();
+	void Error(const string& message) const;	// at the start of the current token
+
+	string name, text;
+	const char *p, *token;
+
+};
+
+#endif
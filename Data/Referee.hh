@@ -17,12 +17,17 @@ class Referee {
 
 public:
 	Referee() {}
+	Referee(int c, int l, Coordinates2D a, int e, const vector<int>& iR, const vector<int>& iT, const vector<Event>& u)	// the vectors must be sorted
+		: code(c), level(l), address(a), experience(e), incompatibleReferees(iR), incompatibleTeams(iT), unavailabilities(u) {}
 	int Code() const { return code; }
 	int Level() const { return level; }
 	Coordinates2D Address() const { return address; }
 	int Experience() const { return experience; }
 	bool IncompatibleReferee(int r) const;
 	bool IncompatibleTeam(int t) const;
+	const vector<int>& IncompatibleReferees() const { return incompatibleReferees; }	// sorted
+	const vector<int>& IncompatibleTeams() const { return incompatibleTeams; }	// sorted
+	const vector<Event>& Unavailabilities() const { return unavailabilities; }	// sorted
 	bool Unavailable(const Event& e) const;
 
 private:
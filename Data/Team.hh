@@ -14,6 +14,7 @@ class Team {
 
 public:
 	Team() {}
+	Team(int c, int d) : code(c), division(d) {}
 	int Code() const { return code; }
 	int Division() const { return division; }
 
@@ -1,6 +1,9 @@
 #ifndef BACKTRACKING_HH
 #define BACKTRACKING_HH
 #include <iostream>
+#include <vector>
+#include <atomic>
+#include <limits>
 
 using namespace std;
 
@@ -9,63 +12,94 @@ class BacktrackingOpt
 {
 public:
   BacktrackingOpt(const Input& i, unsigned fl);
+  virtual ~BacktrackingOpt() {}
   bool Search();
   Output BestSolution() { return best; }
+  CFtype BestCost() const { return best_cost; }
   unsigned NumNodes() const { return count; }
-protected: 
-  virtual void GoDownOneLevel() { level++; }
+  unsigned FinalLevel() const { return final_level; }
+  // subtrees of the search, for a parallel search: a node is identified by the number of siblings before it at each level
+  vector<vector<unsigned>> Prefixes(unsigned depth);	// the feasible nodes of the given level
+  bool SearchFrom(const vector<unsigned>& prefix);	// searches the subtree of the node, returns true if a new best solution is found
+  void ShareIncumbent(atomic<CFtype>* c) { incumbent = c; }	// cost of the best solution among all the searches (max() if none), used for pruning
+  void SetVerbose(bool v) { verbose = v; }
+protected:
+  // the variable of each level is chosen when the level is reached (by default the level itself)
+  virtual void GoDownOneLevel() { level++; level_variable[level] = SelectVariable(); }
+  virtual unsigned SelectVariable() { return level; }
   virtual void GoUpOneLevel(){ level--; }
   virtual void FirstOfLevel() = 0;
   virtual bool NextOfLevel() = 0;
-  virtual bool AtRootLevel() { return level == 0; }
+  virtual bool AtRootLevel() { return level == root_level; }
   virtual bool FullSolution() { return level == final_level; }
   virtual bool Feasible() = 0;
   virtual bool NonImprovingBranch() { return false; }
   virtual CFtype Cost() = 0;
-  unsigned level, final_level;
+  bool HasIncumbent() const { return first_sol_found || (incumbent && *incumbent != numeric_limits<CFtype>::max()); }
+  CFtype IncumbentCost() const;	// the cost to improve, to be used by NonImprovingBranch
+  unsigned level, final_level, root_level;
+  vector<unsigned> level_variable;
   unsigned count;
-  CFtype cost, best_cost;  
+  CFtype cost, best_cost;
   const Input& in;
   Output out, best;
+private:
+  void Explore();	// searches the subtree of the current node, up to the root level
+  void NewSolution();
+  bool first_sol_found, verbose;
+  atomic<CFtype>* incumbent;
 };
 
 template <typename Input, typename Output, typename CFtype>
-BacktrackingOpt<Input,Output,CFtype>::BacktrackingOpt(const Input& i, unsigned fl) 
-  : in(i), out(in), best(in) 
-{ 
-  level = 0; 
-  final_level = fl; 
+BacktrackingOpt<Input,Output,CFtype>::BacktrackingOpt(const Input& i, unsigned fl)
+  : level_variable(fl + 1, 0), in(i), out(in), best(in)
+{
+  level = 0;
+  root_level = 0;
+  final_level = fl;
   count = 0;
+  first_sol_found = false;
+  verbose = true;
+  incumbent = nullptr;
+}
+
+template <typename Input, typename Output, typename CFtype>
+CFtype BacktrackingOpt<Input,Output,CFtype>::IncumbentCost() const
+{
+  if (incumbent && (!first_sol_found || *incumbent < best_cost))
+    return *incumbent;
+  return best_cost;
 }
 
 template <typename Input, typename Output, typename CFtype>
 bool BacktrackingOpt<Input,Output,CFtype>::Search()
 {
-  bool backtrack, first_sol_found = false;
+  root_level = 0;
+  Explore();
+  return first_sol_found;
+}
+
+template <typename Input, typename Output, typename CFtype>
+void BacktrackingOpt<Input,Output,CFtype>::Explore()
+{
+  bool backtrack;
+  if (FullSolution())
+    {
+      NewSolution();
+      return;
+    }
   GoDownOneLevel();
   FirstOfLevel();
   count++;
-  do 
+  do
     {
-      if (first_sol_found)
+      if (HasIncumbent())
         backtrack = !Feasible() || NonImprovingBranch();
       else
         backtrack = !Feasible();
       if (FullSolution() && !backtrack)
         {
-          cost = Cost();
-          if (!first_sol_found || cost < best_cost)
-            {
-              if (first_sol_found)
-                cerr << "New best solution " << endl << out 
-                     << " (current cost " << cost << ", previous " << best_cost << ")" << endl;
-              else
-                cerr << "First solution " << endl << out 
-                     << " (current cost " << cost << ") " << endl;
-              first_sol_found = true;
-              best_cost = cost;
-              best = out;              
-            }
+          NewSolution();
           backtrack = true; // continue search
         }
       if (backtrack)
@@ -85,9 +119,119 @@ bool BacktrackingOpt<Input,Output,CFtype>::Search()
           GoDownOneLevel();
           FirstOfLevel();
 		  count++;
-        } 
+        }
     }
   while (!AtRootLevel());
-  return first_sol_found; 
+}
+
+template <typename Input, typename Output, typename CFtype>
+void BacktrackingOpt<Input,Output,CFtype>::NewSolution()
+{
+  cost = Cost();
+  if (!first_sol_found || cost < best_cost)
+    {
+      if (verbose)
+        {
+          if (first_sol_found)
+            cerr << "New best solution " << endl << out
+                 << " (current cost " << cost << ", previous " << best_cost << ")" << endl;
+          else
+            cerr << "First solution " << endl << out
+                 << " (current cost " << cost << ") " << endl;
+        }
+      first_sol_found = true;
+      best_cost = cost;
+      best = out;
+      if (incumbent)
+        { // lowers the shared cost, unless another search has found a better one meanwhile
+          CFtype c = *incumbent;
+          while (cost < c && !incumbent->compare_exchange_weak(c, cost))
+            ;
+        }
+    }
+}
+
+/* The nodes are enumerated by the same moves of the search (the nodes that
+   are not feasible are skipped, while no pruning on the cost is done), and
+   the search is left at the root. */
+template <typename Input, typename Output, typename CFtype>
+vector<vector<unsigned>> BacktrackingOpt<Input,Output,CFtype>::Prefixes(unsigned depth)
+{
+  vector<vector<unsigned>> prefixes;
+  vector<unsigned> sibling(final_level + 1, 0);
+  bool backtrack;
+  if (depth > final_level)
+    depth = final_level;
+  if (depth == 0)
+    return vector<vector<unsigned>>(1);
+  root_level = 0;
+  GoDownOneLevel();
+  FirstOfLevel();
+  do
+    {
+      backtrack = !Feasible();
+      if (level == depth && !backtrack)
+        {
+          prefixes.push_back(vector<unsigned>(sibling.begin() + 1, sibling.begin() + depth + 1));
+          backtrack = true;
+        }
+      if (backtrack)
+        do
+		{
+          if (NextOfLevel())
+		  {
+		    sibling[level]++;
+            backtrack = false;
+		  }
+          else
+            GoUpOneLevel();
+		}
+        while (backtrack && !AtRootLevel());
+      else
+        {
+          GoDownOneLevel();
+          FirstOfLevel();
+		  sibling[level] = 0;
+        }
+    }
+  while (!AtRootLevel());
+  return prefixes;
+}
+
+/* The node is reached again by the same moves (each sibling is checked for
+   feasibility, as the search does, since Feasible may update the state of
+   the derived class), then its subtree is searched and the search goes back
+   to the root. Only the node itself is counted, not the nodes replayed to
+   reach it, which are shared with the other prefixes. */
+template <typename Input, typename Output, typename CFtype>
+bool BacktrackingOpt<Input,Output,CFtype>::SearchFrom(const vector<unsigned>& prefix)
+{
+  bool feasible = true, found = false;
+  CFtype previous_cost = best_cost;
+  bool previous_found = first_sol_found;
+  root_level = 0;
+  for (unsigned i = 0; i < prefix.size() && feasible; i++)
+    {
+      GoDownOneLevel();
+      FirstOfLevel();
+      feasible = Feasible();
+      for (unsigned k = 0; k < prefix[i]; k++)
+        {
+          NextOfLevel();
+          feasible = Feasible();
+        }
+    }
+  if (!prefix.empty())
+    count++;
+  if (feasible && !(HasIncumbent() && NonImprovingBranch()))
+    {
+      root_level = level;
+      Explore();
+      found = first_sol_found && (!previous_found || best_cost < previous_cost);
+    }
+  root_level = 0;
+  while (!AtRootLevel())
+    GoUpOneLevel();
+  return found;
 }
 #endif
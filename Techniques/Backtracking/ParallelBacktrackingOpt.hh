@@ -0,0 +1,144 @@
+#ifndef PARALLEL_BACKTRACKING_HH
+#define PARALLEL_BACKTRACKING_HH
+#include "BacktrackingOpt.hh"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+/* Parallel branch and bound: the tree is split at a shallow level into the
+   subtrees of its feasible nodes (the subproblems), which are dealt round
+   robin to the workers. Each worker owns a search (made by the factory),
+   takes its subproblems from the back of its own deque, in the order of the
+   sequential search, and, when it runs out of them, steals from the front
+   of the deques of the others. The workers share the cost of the best
+   solution found so far, through an atomic, for pruning. */
+template <typename Input, typename Output, typename CFtype>
+class ParallelBacktrackingOpt
+{
+public:
+  typedef BacktrackingOpt<Input,Output,CFtype> SolverType;
+  // split level 0: the first level with at least subproblems_per_worker subproblems per worker
+  ParallelBacktrackingOpt(function<SolverType*()> new_solver, unsigned threads, unsigned split_level = 0);
+  bool Search();
+  Output BestSolution() { return solvers[best_worker]->BestSolution(); }
+  CFtype BestCost() const { return solvers[best_worker]->BestCost(); }
+  unsigned NumNodes() const;
+  unsigned NumWorkers() const { return solvers.size(); }
+  unsigned WorkerNodes(unsigned w) const { return solvers[w]->NumNodes(); }
+  unsigned WorkerSubproblems(unsigned w) const { return subproblems[w]; }
+  unsigned WorkerSteals(unsigned w) const { return steals[w]; }
+  unsigned WorkerImprovements(unsigned w) const { return improvements[w]; }
+  unsigned SplitLevel() const { return split_level; }
+  unsigned NumSubproblems() const { return num_subproblems; }
+  static const unsigned subproblems_per_worker = 8;
+private:
+  void Work(unsigned w);
+  bool NextSubproblem(unsigned w, vector<unsigned>& prefix);
+  vector<unique_ptr<SolverType>> solvers;
+  vector<deque<vector<unsigned>>> queues;
+  vector<mutex> queue_mutex;
+  vector<unsigned> subproblems, steals, improvements;	// written by their worker only
+  atomic<CFtype> incumbent;
+  unsigned split_level, num_subproblems, best_worker;
+};
+
+template <typename Input, typename Output, typename CFtype>
+ParallelBacktrackingOpt<Input,Output,CFtype>::ParallelBacktrackingOpt(function<SolverType*()> new_solver, unsigned threads, unsigned sl)
+  : queues(max(threads, 1u)), queue_mutex(max(threads, 1u)), subproblems(max(threads, 1u), 0),
+    steals(max(threads, 1u), 0), improvements(max(threads, 1u), 0), incumbent(numeric_limits<CFtype>::max())
+{
+  for (unsigned w = 0; w < queues.size(); w++)
+    {
+      solvers.emplace_back(new_solver());
+      solvers[w]->ShareIncumbent(&incumbent);
+      solvers[w]->SetVerbose(false);
+    }
+  split_level = sl;
+  num_subproblems = 0;
+  best_worker = 0;
+}
+
+template <typename Input, typename Output, typename CFtype>
+bool ParallelBacktrackingOpt<Input,Output,CFtype>::Search()
+{
+  vector<vector<unsigned>> prefixes;
+  vector<thread> workers;
+  unsigned w;
+
+  if (split_level == 0)
+    {
+      do
+        prefixes = solvers[0]->Prefixes(++split_level);
+      while (!prefixes.empty() && prefixes.size() < subproblems_per_worker * solvers.size() && split_level < solvers[0]->FinalLevel());
+    }
+  else
+    prefixes = solvers[0]->Prefixes(split_level);
+  num_subproblems = prefixes.size();
+
+  // the back of each deque is the first subproblem of the worker
+  for (unsigned p = prefixes.size(); p-- > 0; )
+    queues[p % queues.size()].push_back(prefixes[p]);
+
+  for (w = 0; w < solvers.size(); w++)
+    workers.emplace_back(&ParallelBacktrackingOpt::Work, this, w);
+  for (thread& worker : workers)
+    worker.join();
+
+  for (w = 0; w < solvers.size(); w++)
+    if (improvements[w] > 0 && (improvements[best_worker] == 0 || solvers[w]->BestCost() < solvers[best_worker]->BestCost()))
+      best_worker = w;
+  return improvements[best_worker] > 0;
+}
+
+template <typename Input, typename Output, typename CFtype>
+void ParallelBacktrackingOpt<Input,Output,CFtype>::Work(unsigned w)
+{
+  vector<unsigned> prefix;
+  while (NextSubproblem(w, prefix))
+    {
+      subproblems[w]++;
+      if (solvers[w]->SearchFrom(prefix))
+        improvements[w]++;
+    }
+}
+
+/* No subproblem is created during the search, hence all the deques are
+   empty when a worker finds none. */
+template <typename Input, typename Output, typename CFtype>
+bool ParallelBacktrackingOpt<Input,Output,CFtype>::NextSubproblem(unsigned w, vector<unsigned>& prefix)
+{
+  {
+    lock_guard<mutex> lock(queue_mutex[w]);
+    if (!queues[w].empty())
+      {
+        prefix = queues[w].back();
+        queues[w].pop_back();
+        return true;
+      }
+  }
+  for (unsigned k = 1; k < queues.size(); k++)
+    {
+      unsigned v = (w + k) % queues.size();
+      lock_guard<mutex> lock(queue_mutex[v]);
+      if (!queues[v].empty())
+        {
+          prefix = queues[v].front();
+          queues[v].pop_front();
+          steals[w]++;
+          return true;
+        }
+    }
+  return false;
+}
+
+template <typename Input, typename Output, typename CFtype>
+unsigned ParallelBacktrackingOpt<Input,Output,CFtype>::NumNodes() const
+{
+  unsigned count = 0;
+  for (unsigned w = 0; w < solvers.size(); w++)
+    count += solvers[w]->NumNodes();
+  return count;
+}
+#endif
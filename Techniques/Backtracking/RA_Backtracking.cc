@@ -1,100 +1,293 @@
 // File RA_Backtracking.cc
 
 #include "RA_Backtracking.hh"
+#include <cmath>
+#include <algorithm>
+
+/*	Forward checking: each game keeps the domain of the referees that can
+	still be assigned to it, initially the available ones with the required
+	level. When the referees of a game are fixed, each of them is removed
+	from the domains of the open games that overlap with it (for that
+	referee), and the branch is pruned as soon as a domain gets smaller than
+	the minimum number of referees of its game. The removals are recorded on
+	a trail and undone when the level is left or changes its assignment. The
+	levels enumerate only the subsets of their domain.
+	Removing a referee for a game that would not be adjacent to the other
+	one in its schedule is safe: the games are sorted by time, hence a game
+	in between would overlap with the first one or leave even less time to
+	reach the second one (up to the rounding of the travel times, which is
+	far smaller than the length of a game).
+*/
+BacktrackingRAOpt::BacktrackingRAOpt(const RA_Input& in, unsigned fl, GameOrdering o)
+	: BacktrackingOpt(in, fl), ordering(o), placed(in.NumGames() + 1, false), conflicting(in.NumGames() + 1),
+	  domain(in.NumGames() + 1, vector<bool>(in.NumReferees() + 1)), domainSize(in.NumGames() + 1, 0),
+	  trailMark(fl + 1, 0), candidates(in.NumGames() + 1), combination(in.NumGames() + 1),
+	  openGamesOfDate(in.NumDates() + 1, 0), lowerBound(fl + 1, 0) {
+	int maxDistance = 0, travelDays;
+
+	for (int d = 1; d <= in.NumDates(); d++)
+		openGamesOfDate[d] = in.FirstGameOfDate(d + 1) - in.FirstGameOfDate(d);
+
+	for (int g = 1; g <= in.NumGames(); g++) {
+		const Game &game = in.GetGame(g);
+		const Division &division = in.GetDivision(game.Division());
+
+		for (int r = 1; r <= in.NumReferees(); r++)
+			if (!in.GetReferee(r).Unavailable(game.Match()) && in.GetReferee(r).Level() >= division.Level()) {
+				domain[g][r] = true;
+				domainSize[g]++;
+			}
+	}
+
+	// the longest travel between two games, through the home of a referee or not, bounds the games that may overlap
+	for (int a = 1; a <= in.NumArenas(); a++) {
+		for (int b = 1; b <= in.NumArenas(); b++)
+			maxDistance = max(maxDistance, EuclideanDistance(in.GetArena(a).Address(), in.GetArena(b).Address()));
+		for (int r = 1; r <= in.NumReferees(); r++)
+			maxDistance = max(maxDistance, 2 * EuclideanDistance(in.GetArena(a).Address(), in.GetReferee(r).Address()));
+	}
+	travelDays = static_cast<int>(ceil(static_cast<double>(maxDistance) / out.AverageSpeed() / 24.0)) + 1;
+
+	for (int g = 1; g <= in.NumGames(); g++) {
+		Date limit = in.GetGame(g).Match().EndDate() + travelDays;
+
+		for (int h = g + 1; h <= in.NumGames() && !(limit < in.GetGame(h).Match().StartDate()); h++)
+			for (int r = 1; r <= in.NumReferees(); r++)
+				if (domain[g][r] && domain[h][r] && out.OverlappingGames(in.GetGame(g), in.GetGame(h), r)) {
+					conflicting[g].push_back(h);
+					conflicting[h].push_back(g);
+					break;
+				}
+	}
+
+	for (int g = 1; g <= in.NumGames(); g++)
+		sort(conflicting[g].begin(), conflicting[g].end());
+}
 
 void BacktrackingRAOpt::FirstOfLevel() {
-	int g = level;
+	int g = level_variable[level];
 	const Division &division = in.GetDivision(in.GetGame(g).Division());
 
-	for (int r = 1; r <= division.MinReferees(); r++)
-		out.Assign(r, g);
+	candidates[g].clear();
+	for (int r = 1; r <= in.NumReferees(); r++)
+		if (domain[g][r])
+			candidates[g].push_back(r);
+
+	combination[g].clear();
+	if (static_cast<int>(candidates[g].size()) >= division.MinReferees())
+		for (int i = 0; i < division.MinReferees(); i++)
+			combination[g].push_back(i);
+
+	placed[g] = true;
+	openGamesOfDate[in.DateOf(g)]--;
+	AssignCombination(g);
 }
 
 bool BacktrackingRAOpt::NextOfLevel() {
-	int g = level;
+	int g = level_variable[level];
 
+	Undo(level);
 	return HasNext(g);
 }
 
 bool BacktrackingRAOpt::Feasible() {
-	int g = level;
+	int g = level_variable[level];
 	int referee;
 
+	trailMark[level] = trail.size();
+
 	if (!out.HasMinimumReferees(g))
 		return false;
 
 	if (!out.LeqThanMaximumReferees(g))
 		return false;
 
+	// the other games of the referees have been checked at their own level, only g is new
 	for (set<int>::iterator it = out.AssignedReferees(g).begin(); it != out.AssignedReferees(g).end(); ++it) {
 		referee = in.GetReferee(*it).Code();
 
-		if (!out.FeasibleTravelDistance(referee))
+		if (!FeasibleSchedule(referee, g))
 			return false;
+	}
 
-		if (!out.RefereeAvailability(referee))
-			return false;
+	// the date of g is complete once g is its last game placed
+	lowerBound[level] = lowerBound[level - 1] + GameCost(g);
+	if (openGamesOfDate[in.DateOf(g)] == 0)
+		lowerBound[level] += DateDistance(in.DateOf(g));
 
-		if (!out.HasMinimumLevel(referee))
-			return false;
-	}
+	return Propagate(g);
+}
+
+/*	Incremental version of RA_Output::FeasibleTravelDistance: the schedule of
+	the referee without g is feasible, hence only the pairs made by g with its
+	predecessor and its successor in the schedule have to be checked.
+*/
+bool BacktrackingRAOpt::FeasibleSchedule(int r, int g) const {
+	const set<int>& assignedGames = out.AssignedGames(r);
+	set<int>::const_iterator it = assignedGames.find(g);
+	const Game &game = in.GetGame(g);
+
+	if (it != assignedGames.begin() && out.OverlappingGames(in.GetGame(*prev(it)), game, r))
+		return false;
+
+	if (next(it) != assignedGames.end() && out.OverlappingGames(game, in.GetGame(*next(it)), r))
+		return false;
+
+	return true;
+}
+
+bool BacktrackingRAOpt::Propagate(int g) {
+	const Game &game = in.GetGame(g);
+
+	for (int h : conflicting[g])
+		if (!placed[h])
+			for (int r : out.AssignedReferees(g))
+				if (domain[h][r] && (h < g ? out.OverlappingGames(in.GetGame(h), game, r) : out.OverlappingGames(game, in.GetGame(h), r))) {
+					domain[h][r] = false;
+					domainSize[h]--;
+					trail.push_back(make_pair(h, r));
+
+					if (domainSize[h] < in.GetDivision(in.GetGame(h).Division()).MinReferees())
+						return false;
+				}
 
 	return true;
 }
 
+void BacktrackingRAOpt::Undo(unsigned l) {
+	while (trail.size() > trailMark[l]) {
+		domain[trail.back().first][trail.back().second] = true;
+		domainSize[trail.back().first]++;
+		trail.pop_back();
+	}
+}
+
 int BacktrackingRAOpt::Cost() {
 	return out.ComputeCost();
 }
 
+/*	Admissible lower bound of the cost of any completion of the current
+	partial solution, computed incrementally along the levels:
+	- LackOfExperience, OptionalReferee, RefereeIncompatibility and
+	  TeamIncompatibility depend only on the referees of their game, hence
+	  they are exact for the placed games and zero for the others
+	- the TotalDistance is made of one tour from home for each referee and
+	  date, which is exact once all the games of the date are placed and is
+	  taken as zero before
+	- GamesDistribution and AssignmentFrequency can decrease when games are
+	  added, and are taken as zero (e.g. in Handcrafted_Instances/Backtracking_NIB.txt
+	  with only their weights set a bound on them would miss the optimum)
+*/
 bool BacktrackingRAOpt::NonImprovingBranch() {
-	return false;
-	// return out.ComputeCost() >= best_cost;	// NOT (exactly) correct due to the approximations made in the GamesDistribution and AssignmentFrequency soft constraints.
-												// There are instances for which the optimal solution is NOT found. As an example, test the Handcrafted_Instances/Backtracking_NIB.txt
-												// instance with all weights equal 0 except those for GamesDistribution and AssignmentFrequency.
+	return lowerBound[level] >= IncumbentCost();
+}
+
+int BacktrackingRAOpt::GameCost(int g) const {
+	int cost = 0;
+
+	if (out.LackOfExperience(g))
+		cost += in.LackOfExperienceWeight();
+	cost += in.OptionalRefereeWeight() * out.OptionalReferee(g);
+	cost += in.RefereeIncompatibilityWeight() * out.RefereeIncompatibility(g);
+	cost += in.TeamIncompatibilityWeight() * out.TeamIncompatibility(g);
+
+	return cost;
+}
+
+int BacktrackingRAOpt::DateDistance(int d) const {
+	int distance = 0;
+
+	for (int r = 1; r <= in.NumReferees(); r++) {
+		const set<int>& assignedGames = out.AssignedGames(r);
+		set<int>::const_iterator it = assignedGames.lower_bound(in.FirstGameOfDate(d));
+		Coordinates2D home = in.GetReferee(r).Address(), position = home;
+
+		for (; it != assignedGames.end() && *it < in.FirstGameOfDate(d + 1); ++it) {
+			Coordinates2D arena = in.GetArena(in.GetGame(*it).Arena()).Address();
+			distance += EuclideanDistance(position, arena);
+			position = arena;
+		}
+		distance += EuclideanDistance(position, home);
+	}
+
+	return in.TotalDistanceWeight() * distance;
 }
 
 void BacktrackingRAOpt::GoUpOneLevel() {
-	int g = level;
+	int g = level_variable[level];
+	Undo(level);
 	out.UnassignAll(g);
+	placed[g] = false;
+	openGamesOfDate[in.DateOf(g)]++;
 	BacktrackingOpt::GoUpOneLevel();
 }
 
-bool BacktrackingRAOpt::HasNext(int g) {
-	const Division &division = in.GetDivision(in.GetGame(g).Division());
-	set<int>::reverse_iterator rit;
-	vector<int> removeReferees;
-	int referee;
+/*	Most constrained game first: the open game with the fewest candidates
+	beyond its MinReferees (the most likely to fail), ties broken by the
+	number of open games conflicting with it (the game that constrains the
+	most the rest of the search).
+*/
+unsigned BacktrackingRAOpt::SelectVariable() {
+	int selected = 0, selectedSlack = 0, selectedDegree = 0;
 
-	for (rit = out.AssignedReferees(g).rbegin(); rit != out.AssignedReferees(g).rend(); ++rit) {
-		referee = in.GetReferee(*rit).Code();
+	if (ordering == INDEX_ORDERING)
+		return level;
 
-		if (referee == in.NumReferees() - static_cast<int>(removeReferees.size()))
-			removeReferees.push_back(referee);
-		else
-			break;
-	}
+	for (int g = 1; g <= in.NumGames(); g++)
+		if (!placed[g]) {
+			int slack = domainSize[g] - in.GetDivision(in.GetGame(g).Division()).MinReferees(), degree = 0;
+
+			if (selected != 0 && slack > selectedSlack)
+				continue;
+
+			for (int h : conflicting[g])
+				if (!placed[h])
+					degree++;
+
+			if (selected == 0 || slack < selectedSlack || degree > selectedDegree) {
+				selected = g;
+				selectedSlack = slack;
+				selectedDegree = degree;
+			}
+		}
+
+	return selected;
+}
 
-	if (static_cast<int>(removeReferees.size()) == division.MaxReferees())
+/*	Next subset of the candidates of the game: the subsets of MinReferees
+	candidates in lexicographic order, then those of MinReferees + 1, and so
+	on up to MaxReferees.
+*/
+bool BacktrackingRAOpt::HasNext(int g) {
+	const Division &division = in.GetDivision(in.GetGame(g).Division());
+	vector<int> &c = combination[g];
+	int m = static_cast<int>(candidates[g].size()), k = static_cast<int>(c.size()), i = k - 1;
+
+	if (m < division.MinReferees())
 		return false;
 
-	for (int r : removeReferees)
-		out.Unassign(r, g);
+	while (i >= 0 && c[i] == m - k + i)
+		i--;
 
-	if (out.AssignedReferees(g).empty()) {
-		for (int r = 1; r <= static_cast<int>(removeReferees.size()) + 1; r++)
-			out.Assign(r, g);
+	if (i >= 0) {
+		c[i]++;
+		for (int j = i + 1; j < k; j++)
+			c[j] = c[j - 1] + 1;
 	} else {
-		rit = out.AssignedReferees(g).rbegin();
-		referee = in.GetReferee(*rit).Code();
-		out.Unassign(referee, g);
-		referee++;
-		out.Assign(referee, g);
-
-		for (int i = 0; i < static_cast<int>(removeReferees.size()); i++) {
-			referee++;
-			out.Assign(referee, g);
-		}
+		k++;
+		if (k > division.MaxReferees() || k > m)
+			return false;
+		c.resize(k);
+		for (int j = 0; j < k; j++)
+			c[j] = j;
 	}
 
+	AssignCombination(g);
 	return true;
 }
+
+void BacktrackingRAOpt::AssignCombination(int g) {
+	out.UnassignAll(g);
+	for (int i : combination[g])
+		out.Assign(candidates[g][i], g);
+}
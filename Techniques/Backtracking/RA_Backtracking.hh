@@ -5,11 +5,17 @@
 
 #include "BacktrackingOpt.hh"
 #include <RA_Data.hh>
+#include <vector>
+
+enum GameOrdering {
+	INDEX_ORDERING,	// the games in their order (i.e. by date)
+	MOST_CONSTRAINED_ORDERING	// the game with the fewest candidates beyond its MinReferees, then with the most conflicting games
+};
 
 class BacktrackingRAOpt : public BacktrackingOpt<RA_Input, RA_Output, int> {
 
 public:
-	BacktrackingRAOpt(const RA_Input& in, unsigned fl) : BacktrackingOpt(in, fl) {}
+	BacktrackingRAOpt(const RA_Input& in, unsigned fl, GameOrdering o = INDEX_ORDERING);
 
 protected:
 	// hot-spots
@@ -20,9 +26,28 @@ protected:
 	// cold-spots
 	bool NonImprovingBranch();
 	void GoUpOneLevel();
+	unsigned SelectVariable();
 
 private:
 	bool HasNext(int g);
+	void AssignCombination(int g);
+	bool FeasibleSchedule(int r, int g) const;	// checks the game g against the adjacent games of the referee r
+	bool Propagate(int g);	// removes the referees of g from the domains of the open games they cannot combine with, false on a wipeout
+	void Undo(unsigned l);	// restores the domains reduced at the level l
+	int GameCost(int g) const;	// the (weighted) soft costs that depend only on the referees of g
+	int DateDistance(int d) const;	// the (weighted) travel distance of the referees on the date d
+
+	GameOrdering ordering;
+	vector<bool> placed;	// the games of the levels above the current one (included)
+	vector<vector<int>> conflicting;	// the games that overlap with each game for at least one referee eligible for both (in increasing order)
+	vector<vector<bool>> domain;	// domain[g][r]: the referee r can still be assigned to the game g
+	vector<int> domainSize;
+	vector<pair<int, int>> trail;	// (game, referee) removed from the domains, in order of removal
+	vector<size_t> trailMark;	// size of the trail before the propagation of each level (indexed by level)
+	vector<vector<int>> candidates;	// the domain of each level when it was reached
+	vector<vector<int>> combination;	// the current subset of the candidates of each level (indices, increasing)
+	vector<int> openGamesOfDate;	// the games of each date not placed yet
+	vector<int> lowerBound;	// lower bound of the cost of the solutions below each level (indexed by level)
 
 };
 
@@ -1,6 +1,7 @@
 // File TestRABacktracking.cc
 
 #include "RA_Backtracking.hh"
+#include "ParallelBacktrackingOpt.hh"
 #include <iostream>
 #include <chrono>
 #include <string>
@@ -8,7 +9,8 @@
 using namespace std::chrono;
 
 int main(int argc, char* argv[]) {
-	string instance;
+	string instance, ordering = "index";
+	unsigned threads = 1, splitLevel = 0;	// splitLevel 0: chosen by the number of subproblems
 	int loe, gd, td, o, af, ri, ti;	// soft constraints weights
 
 	if (argc == 1) {
@@ -44,7 +46,7 @@ int main(int argc, char* argv[]) {
   		cin >> ri;
   		cout << "TeamIncompatibility weight: ";
   		cin >> ti;
-  	} else if (argc == 9) {
+  	} else if (argc >= 9 && argc <= 12) {
   		instance = argv[1];
   		loe = stoi(argv[2]);
   		gd = stoi(argv[3]);
@@ -53,12 +55,18 @@ int main(int argc, char* argv[]) {
   		af = stoi(argv[6]);
   		ri = stoi(argv[7]);
   		ti = stoi(argv[8]);
+  		if (argc >= 10)
+  			ordering = argv[9];
+  		if (argc >= 11)
+  			threads = stoi(argv[10]);
+  		if (argc == 12)
+  			splitLevel = stoi(argv[11]);
 	} else {
-		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti]]" << endl;
+		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti [index|dynamic [threads [split_level]]]]]" << endl;
       	exit(1);
 	}
 
-	RA_Input in(instance);
+	RA_Input in = ReadInstance(instance);
 
   	in.SetLackOfExperienceWeight(loe);
 	in.SetGamesDistributionWeight(gd);
@@ -68,17 +76,45 @@ int main(int argc, char* argv[]) {
 	in.SetRefereeIncompatibilityWeight(ri);
 	in.SetTeamIncompatibilityWeight(ti);
 
-	BacktrackingRAOpt solver(in, in.NumGames());
+	if (ordering != "index" && ordering != "dynamic") {
+		cerr << "Unknown game ordering " << ordering << endl;
+		exit(1);
+	}
 
+	GameOrdering gameOrdering = ordering == "index" ? INDEX_ORDERING : MOST_CONSTRAINED_ORDERING;
+	bool hasSolution;
 	auto start = high_resolution_clock::now();
-	bool hasSolution = solver.Search();
-	auto stop = high_resolution_clock::now();
+	auto stop = start;
+
+	if (threads > 1) {
+		ParallelBacktrackingOpt<RA_Input, RA_Output, int> solver([&]() { return new BacktrackingRAOpt(in, in.NumGames(), gameOrdering); },
+																 threads, splitLevel);
+
+		start = high_resolution_clock::now();
+		hasSolution = solver.Search();
+		stop = high_resolution_clock::now();
+		if (hasSolution)
+			cout << "Best solution found " << endl << solver.BestSolution()
+				 <<   " (cost " << solver.BestCost() << ", " << solver.NumNodes() << " nodes visited)" << endl;
+		else
+			cout << "No solution exists" << endl;
+		cout << solver.NumSubproblems() << " subproblems at level " << solver.SplitLevel() << endl;
+		for (unsigned w = 0; w < solver.NumWorkers(); w++)
+			cout << "Worker " << w << ": " << solver.WorkerNodes(w) << " nodes, " << solver.WorkerSubproblems(w)
+				 << " subproblems (" << solver.WorkerSteals(w) << " stolen), " << solver.WorkerImprovements(w) << " improvements" << endl;
+	} else {
+		BacktrackingRAOpt solver(in, in.NumGames(), gameOrdering);
+
+		start = high_resolution_clock::now();
+		hasSolution = solver.Search();
+		stop = high_resolution_clock::now();
+		if (hasSolution)
+			cout << "Best solution found " << endl << solver.BestSolution()
+				 <<   " (cost " << solver.BestCost() << ", " << solver.NumNodes() << " nodes visited)" << endl;
+		else
+			cout << "No solution exists" << endl;
+	}
 	auto duration = stop - start;
-	if (hasSolution)
-		cout << "Best solution found " << endl << solver.BestSolution()
-			 <<   " (" << solver.NumNodes() << " nodes visited)" << endl;
-	else
-		cout << "No solution exists" << endl;
 	cout << "Elapsed time: " << duration_cast<milliseconds>(duration).count() / 1000.0 << " s" << endl;
 	return 0;
 }
@@ -9,35 +9,88 @@ class EnumerationOpt
 {
 public:
   EnumerationOpt(const Input& in);
+  virtual ~EnumerationOpt() {}
   bool Search();
+  // enumeration split by the values of the first variables (the prefix), for a parallel search
+  void SetPrefixLength(unsigned l) { prefix_length = l; }
+  bool SearchPrefix(long long unsigned p);	// enumerates the solutions of the p-th prefix (p must increase at each call), false if there is none
   Output BestSolution() { return best; }
+  CFtype BestCost() const { return best_cost; }
+  bool SolutionFound() const { return first_sol_found; }
   long long unsigned NumSol() const { return count; }
-protected:  
+  void SetVerbose(bool v) { verbose = v; }
+protected:
   virtual void First() = 0;
-  virtual bool Next() = 0;
+  virtual bool Next() = 0;	// changes only the variables after the prefix
+  virtual bool NextPrefix() = 0;	// changes only the variables of the prefix
   virtual bool Feasible() = 0;
   virtual CFtype Cost() = 0;
   long long unsigned count;
+  unsigned prefix_length;
   const Input& in;
   Output out, best;
+private:
+  void Enumerate();
+  CFtype best_cost;
+  bool first_sol_found, verbose;
+  long long unsigned prefix;	// the prefix of the current solution
+  bool started, exhausted;
 };
 
 template <typename Input, typename Output, typename CFtype>
-EnumerationOpt<Input,Output,CFtype>::EnumerationOpt(const Input& i) 
-  : in(i), out(i), best(i) 
+EnumerationOpt<Input,Output,CFtype>::EnumerationOpt(const Input& i)
+  : in(i), out(i), best(i)
 {
   count = 0;
+  prefix_length = 0;
+  best_cost = 0;
+  first_sol_found = false;
+  verbose = true;
+  prefix = 0;
+  started = false;
+  exhausted = false;
 }
 
 template <typename Input, typename Output, typename CFtype>
 bool EnumerationOpt<Input,Output,CFtype>::Search()
 {
-  CFtype cost, best_cost = 0;
-  bool first_sol_found = false;
-
+  prefix_length = 0;
   First();
   count = 1;
-  do 
+  Enumerate();
+  return first_sol_found;
+}
+
+/* The prefixes are reached by NextPrefix from the current one, hence each
+   search visits them in increasing order and the solutions of the skipped
+   ones are left to the other searches. */
+template <typename Input, typename Output, typename CFtype>
+bool EnumerationOpt<Input,Output,CFtype>::SearchPrefix(long long unsigned p)
+{
+  if (!started)
+    {
+      First();
+      started = true;
+    }
+  while (!exhausted && prefix < p)
+    {
+      if (NextPrefix())
+        prefix++;
+      else
+        exhausted = true;
+    }
+  if (exhausted || prefix > p)
+    return false;
+  Enumerate();
+  return true;
+}
+
+template <typename Input, typename Output, typename CFtype>
+void EnumerationOpt<Input,Output,CFtype>::Enumerate()
+{
+  CFtype cost;
+
+  do
     {
       if (Feasible())
         {
@@ -45,16 +98,16 @@ bool EnumerationOpt<Input,Output,CFtype>::Search()
           if (!first_sol_found || cost < best_cost)
             {
               first_sol_found = true;
-              best = out;              
+              best = out;
               best_cost = cost;
-              cerr << "New best solution" << endl << best 
-                   << " (cost " << best_cost << ") " 
-                   << " found after " << count << " iterations" << endl;
+              if (verbose)
+                cerr << "New best solution" << endl << best
+                     << " (cost " << best_cost << ") "
+                     << " found after " << count << " iterations" << endl;
             }
         }
       count++;
     }
   while (Next());
-  return first_sol_found;      
 }
 #endif
@@ -0,0 +1,87 @@
+#ifndef PARALLEL_ENUMERATION_OPT_HPP
+#define PARALLEL_ENUMERATION_OPT_HPP
+#include "EnumerationOpt.hh"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+/* Parallel enumeration: the solutions are split by the values of the first
+   prefix_length variables into independent ranges, one for each prefix.
+   Each worker owns an enumeration (made by the factory) and takes the next
+   prefix from a shared counter; since the prefixes are taken in increasing
+   order, each worker reaches its next prefix by moving forward from the
+   current one. */
+template <typename Input, typename Output, typename CFtype>
+class ParallelEnumerationOpt
+{
+public:
+  typedef EnumerationOpt<Input,Output,CFtype> SolverType;
+  ParallelEnumerationOpt(function<SolverType*()> new_solver, unsigned threads, unsigned prefix_length = 1);
+  bool Search();
+  Output BestSolution() { return solvers[best_worker]->BestSolution(); }
+  CFtype BestCost() const { return solvers[best_worker]->BestCost(); }
+  long long unsigned NumSol() const;
+  unsigned NumWorkers() const { return solvers.size(); }
+  long long unsigned WorkerSol(unsigned w) const { return solvers[w]->NumSol(); }
+  long long unsigned WorkerPrefixes(unsigned w) const { return prefixes[w]; }
+  long long unsigned NumPrefixes() const { return next_prefix; }
+private:
+  void Work(unsigned w);
+  vector<unique_ptr<SolverType>> solvers;
+  vector<long long unsigned> prefixes;	// written by their worker only
+  atomic<long long unsigned> next_prefix;
+  unsigned best_worker;
+};
+
+template <typename Input, typename Output, typename CFtype>
+ParallelEnumerationOpt<Input,Output,CFtype>::ParallelEnumerationOpt(function<SolverType*()> new_solver, unsigned threads,
+                                                                    unsigned prefix_length)
+  : prefixes(max(threads, 1u), 0), next_prefix(0)
+{
+  for (unsigned w = 0; w < prefixes.size(); w++)
+    {
+      solvers.emplace_back(new_solver());
+      solvers[w]->SetPrefixLength(prefix_length);
+      solvers[w]->SetVerbose(false);
+    }
+  best_worker = 0;
+}
+
+template <typename Input, typename Output, typename CFtype>
+bool ParallelEnumerationOpt<Input,Output,CFtype>::Search()
+{
+  vector<thread> workers;
+  unsigned w;
+
+  next_prefix = 0;
+  for (w = 0; w < solvers.size(); w++)
+    workers.emplace_back(&ParallelEnumerationOpt::Work, this, w);
+  for (thread& worker : workers)
+    worker.join();
+  // each worker has taken one prefix past the last one
+  next_prefix -= solvers.size();
+
+  for (w = 0; w < solvers.size(); w++)
+    if (solvers[w]->SolutionFound() && (!solvers[best_worker]->SolutionFound() || solvers[w]->BestCost() < solvers[best_worker]->BestCost()))
+      best_worker = w;
+  return solvers[best_worker]->SolutionFound();
+}
+
+template <typename Input, typename Output, typename CFtype>
+void ParallelEnumerationOpt<Input,Output,CFtype>::Work(unsigned w)
+{
+  while (solvers[w]->SearchPrefix(next_prefix++))
+    prefixes[w]++;
+}
+
+template <typename Input, typename Output, typename CFtype>
+long long unsigned ParallelEnumerationOpt<Input,Output,CFtype>::NumSol() const
+{
+  long long unsigned count = 0;
+  for (unsigned w = 0; w < solvers.size(); w++)
+    count += solvers[w]->NumSol();
+  return count;
+}
+#endif
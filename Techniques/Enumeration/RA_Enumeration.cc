@@ -1,38 +1,213 @@
 // File RA_Enumeration.cc
 
 #include "RA_Enumeration.hh"
+#include <cmath>
+
+/*	Incremental evaluation: consecutive solutions differ in the referees of
+	one game (and of the games before it, at the carries), hence the
+	assignments and removals of referees update the counters and mark the
+	terms they change, which are recomputed only when they are needed: the
+	schedules of the referees by Feasible, the costs of the games, of the
+	referees and of the teams by Cost (i.e. for the feasible solutions only).
+	The number of referees of each game is kept between MinReferees and
+	MaxReferees by the enumeration.
+*/
+EnumerationRAOpt::EnumerationRAOpt(const RA_Input& in)
+	: EnumerationOpt(in), eligible(in.NumGames() + 1, vector<bool>(in.NumReferees() + 1)),
+	  gameCost(in.NumGames() + 1, 0), refereeDistance(in.NumReferees() + 1, 0), teamFrequency(in.NumTeams() + 1, 0),
+	  infeasibleSchedule(in.NumReferees() + 1, false), refereeTeamGames(in.NumReferees() + 1, vector<int>(in.NumTeams() + 1, 0)),
+	  teamReferees(in.NumTeams() + 1, 0), scheduleChanged(in.NumReferees() + 1, false), distanceChanged(in.NumReferees() + 1, false),
+	  gameChanged(in.NumGames() + 1, false), teamChanged(in.NumTeams() + 1, false) {
+	ineligibleAssignments = infeasibleSchedules = 0;
+	assignments = totalGameCost = totalDistance = totalFrequency = 0;
 
-void EnumerationRAOpt::First() {
 	for (int g = 1; g <= in.NumGames(); g++) {
-		const Division &division = in.GetDivision(in.GetGame(g).Division());
+		const Game &game = in.GetGame(g);
 
-		for (int r = 1; r <= division.MinReferees(); r++)
-			out.Assign(r, g);
+		for (int r = 1; r <= in.NumReferees(); r++)
+			eligible[g][r] = !in.GetReferee(r).Unavailable(game.Match())
+				&& in.GetReferee(r).Level() >= in.GetDivision(game.Division()).Level();
 	}
 }
 
+void EnumerationRAOpt::First() {
+	for (int g = 1; g <= in.NumGames(); g++)
+		ResetGame(g);
+}
+
 bool EnumerationRAOpt::Next() {
-	for (int g = 1; g <= in.NumGames(); g++) {
+	return NextOfGames(prefix_length + 1, in.NumGames());
+}
+
+bool EnumerationRAOpt::NextPrefix() {
+	return NextOfGames(1, prefix_length);
+}
+
+bool EnumerationRAOpt::NextOfGames(int first, int last) {
+	for (int g = first; g <= last; g++) {
 		if (HasNext(g))
 			return true;
-		else {
-			out.UnassignAll(g);
-			const Division &division = in.GetDivision(in.GetGame(g).Division());
-
-			for (int r = 1; r <= division.MinReferees(); r++)
-				out.Assign(r, g);
-		}
+		else
+			ResetGame(g);
 	}
 
 	return false;
 }
 
+void EnumerationRAOpt::ResetGame(int g) {
+	const Division &division = in.GetDivision(in.GetGame(g).Division());
+
+	while (!out.AssignedReferees(g).empty())
+		Unassign(*out.AssignedReferees(g).begin(), g);
+	for (int r = 1; r <= division.MinReferees(); r++)
+		Assign(r, g);
+}
+
 bool EnumerationRAOpt::Feasible() {
-	return !out.HasViolations();
+	if (ineligibleAssignments > 0)
+		return false;
+
+	UpdateSchedules();
+	return infeasibleSchedules == 0;
 }
 
+/*	Same as RA_Output::ComputeCost, the GamesDistribution is recomputed as it
+	depends on the number of assignments of all the referees.
+*/
 int EnumerationRAOpt::Cost() {
-	return out.ComputeCost();
+	double averageAssignedGames = static_cast<double>(assignments) / in.NumReferees();
+	int gamesDistribution = 0;
+
+	UpdateCosts();
+	for (int r = 1; r <= in.NumReferees(); r++)
+		gamesDistribution += static_cast<int>(ceil(fabs(averageAssignedGames - out.AssignedGames(r).size())));
+
+	return totalGameCost + in.GamesDistributionWeight() * gamesDistribution
+		+ in.TotalDistanceWeight() * totalDistance + in.AssignmentFrequencyWeight() * totalFrequency;
+}
+
+void EnumerationRAOpt::Assign(int r, int g) {
+	const Game &game = in.GetGame(g);
+
+	out.Assign(r, g);
+	assignments++;
+	if (!eligible[g][r])
+		ineligibleAssignments++;
+	refereeTeamGames[r][game.HomeTeam()]++;
+	refereeTeamGames[r][game.AwayTeam()]++;
+	teamReferees[game.HomeTeam()]++;
+	teamReferees[game.AwayTeam()]++;
+
+	if (!scheduleChanged[r]) {
+		scheduleChanged[r] = true;
+		changedSchedules.push_back(r);
+	}
+	if (!distanceChanged[r]) {
+		distanceChanged[r] = true;
+		changedDistances.push_back(r);
+	}
+	if (!gameChanged[g]) {
+		gameChanged[g] = true;
+		changedGames.push_back(g);
+	}
+	for (int t : {game.HomeTeam(), game.AwayTeam()})
+		if (!teamChanged[t]) {
+			teamChanged[t] = true;
+			changedTeams.push_back(t);
+		}
+}
+
+void EnumerationRAOpt::Unassign(int r, int g) {
+	const Game &game = in.GetGame(g);
+
+	out.Unassign(r, g);
+	assignments--;
+	if (!eligible[g][r])
+		ineligibleAssignments--;
+	refereeTeamGames[r][game.HomeTeam()]--;
+	refereeTeamGames[r][game.AwayTeam()]--;
+	teamReferees[game.HomeTeam()]--;
+	teamReferees[game.AwayTeam()]--;
+
+	if (!scheduleChanged[r]) {
+		scheduleChanged[r] = true;
+		changedSchedules.push_back(r);
+	}
+	if (!distanceChanged[r]) {
+		distanceChanged[r] = true;
+		changedDistances.push_back(r);
+	}
+	if (!gameChanged[g]) {
+		gameChanged[g] = true;
+		changedGames.push_back(g);
+	}
+	for (int t : {game.HomeTeam(), game.AwayTeam()})
+		if (!teamChanged[t]) {
+			teamChanged[t] = true;
+			changedTeams.push_back(t);
+		}
+}
+
+void EnumerationRAOpt::UpdateSchedules() {
+	for (int r : changedSchedules) {
+		if (infeasibleSchedule[r])
+			infeasibleSchedules--;
+		infeasibleSchedule[r] = !out.FeasibleTravelDistance(r);
+		if (infeasibleSchedule[r])
+			infeasibleSchedules++;
+		scheduleChanged[r] = false;
+	}
+	changedSchedules.clear();
+}
+
+void EnumerationRAOpt::UpdateCosts() {
+	for (int r : changedDistances) {
+		totalDistance -= refereeDistance[r];
+		refereeDistance[r] = out.TotalDistance(r);
+		totalDistance += refereeDistance[r];
+		distanceChanged[r] = false;
+	}
+	changedDistances.clear();
+
+	for (int g : changedGames) {
+		totalGameCost -= gameCost[g];
+		gameCost[g] = GameCost(g);
+		totalGameCost += gameCost[g];
+		gameChanged[g] = false;
+	}
+	changedGames.clear();
+
+	for (int t : changedTeams) {
+		totalFrequency -= teamFrequency[t];
+		teamFrequency[t] = TeamFrequency(t);
+		totalFrequency += teamFrequency[t];
+		teamChanged[t] = false;
+	}
+	changedTeams.clear();
+}
+
+int EnumerationRAOpt::GameCost(int g) const {
+	int cost = 0;
+
+	if (out.LackOfExperience(g))
+		cost += in.LackOfExperienceWeight();
+	cost += in.OptionalRefereeWeight() * out.OptionalReferee(g);
+	cost += in.RefereeIncompatibilityWeight() * out.RefereeIncompatibility(g);
+	cost += in.TeamIncompatibilityWeight() * out.TeamIncompatibility(g);
+
+	return cost;
+}
+
+// as in RA_Output::AssignmentFrequency, for all the referees
+int EnumerationRAOpt::TeamFrequency(int t) const {
+	double averageAssignedReferee = static_cast<double>(teamReferees[t]) / in.NumReferees();
+	int frequency = 0;
+
+	for (int r = 1; r <= in.NumReferees(); r++)
+		if (refereeTeamGames[r][t] > averageAssignedReferee)
+			frequency += static_cast<int>(ceil(refereeTeamGames[r][t] - averageAssignedReferee));
+
+	return frequency;
 }
 
 bool EnumerationRAOpt::HasNext(int g) {
@@ -54,21 +229,21 @@ bool EnumerationRAOpt::HasNext(int g) {
 		return false;
 
 	for (int r : removeReferees)
-		out.Unassign(r, g);
+		Unassign(r, g);
 
 	if (out.AssignedReferees(g).empty()) {
 		for (int r = 1; r <= static_cast<int>(removeReferees.size()) + 1; r++)
-			out.Assign(r, g);
+			Assign(r, g);
 	} else {
 		rit = out.AssignedReferees(g).rbegin();
 		referee = in.GetReferee(*rit).Code();
-		out.Unassign(referee, g);
+		Unassign(referee, g);
 		referee++;
-		out.Assign(referee, g);
+		Assign(referee, g);
 
 		for (int i = 0; i < static_cast<int>(removeReferees.size()); i++) {
 			referee++;
-			out.Assign(referee, g);
+			Assign(referee, g);
 		}
 	}
 
@@ -3,19 +3,41 @@
 #include "EnumerationOpt.hh"
 #include <RA_Data.hh>
 #include <set>
+#include <vector>
 
 class EnumerationRAOpt : public EnumerationOpt<RA_Input, RA_Output, int> {
 
 public:
-	EnumerationRAOpt(const RA_Input& in) : EnumerationOpt(in) {}
+	EnumerationRAOpt(const RA_Input& in);
 
 protected:
 	void First();
 	bool Next();
+	bool NextPrefix();
 	bool Feasible();
 	int Cost();
 
 private:
 	bool HasNext(int g);
+	bool NextOfGames(int first, int last);	// next combination of the games from first to last, the first one changing fastest
+	void ResetGame(int g);	// assigns the first MinReferees referees to the game
+	// incremental evaluation
+	void Assign(int r, int g);
+	void Unassign(int r, int g);
+	void UpdateSchedules();	// recomputes the feasibility of the schedules changed since the last call
+	void UpdateCosts();	// recomputes the costs changed since the last call
+	int GameCost(int g) const;	// the (weighted) soft costs that depend only on the referees of g
+	int TeamFrequency(int t) const;	// the AssignmentFrequency of all the referees for the team
+
+	vector<vector<bool>> eligible;	// eligible[g][r]: the referee r is available for g and has its level
+	vector<int> gameCost, refereeDistance, teamFrequency;
+	vector<bool> infeasibleSchedule;
+	vector<vector<int>> refereeTeamGames;	// refereeTeamGames[r][t]: games of the team t assigned to the referee r
+	vector<int> teamReferees;	// referees assigned to the games of each team
+	int ineligibleAssignments, infeasibleSchedules;
+	int assignments, totalGameCost, totalDistance, totalFrequency;
+	// the games, referees and teams changed since their last update (each one listed once)
+	vector<int> changedSchedules, changedDistances, changedGames, changedTeams;
+	vector<bool> scheduleChanged, distanceChanged, gameChanged, teamChanged;
 
 };
@@ -1,6 +1,7 @@
 // File TestRAEnumeration.cc
 
 #include "RA_Enumeration.hh"
+#include "ParallelEnumerationOpt.hh"
 #include <iostream>
 #include <chrono>
 #include <string>
@@ -9,6 +10,7 @@ using namespace std::chrono;
 
 int main(int argc, char* argv[]) {
 	string instance;
+	unsigned threads = 1, prefixLength = 1;
 	int loe, gd, td, o, af, ri, ti;	// soft constraints weights
 
 	if (argc == 1) {
@@ -44,7 +46,7 @@ int main(int argc, char* argv[]) {
   		cin >> ri;
   		cout << "TeamIncompatibility weight: ";
   		cin >> ti;
-  	} else if (argc == 9) {
+  	} else if (argc >= 9 && argc <= 11) {
   		instance = argv[1];
   		loe = stoi(argv[2]);
   		gd = stoi(argv[3]);
@@ -53,12 +55,16 @@ int main(int argc, char* argv[]) {
   		af = stoi(argv[6]);
   		ri = stoi(argv[7]);
   		ti = stoi(argv[8]);
+  		if (argc >= 10)
+  			threads = stoi(argv[9]);
+  		if (argc == 11)
+  			prefixLength = stoi(argv[10]);
 	} else {
-		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti]]" << endl;
+		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti [threads [prefix_length]]]]" << endl;
       	exit(1);
 	}
 
-	RA_Input in(instance);
+	RA_Input in = ReadInstance(instance);
 
   	in.SetLackOfExperienceWeight(loe);
 	in.SetGamesDistributionWeight(gd);
@@ -68,18 +74,39 @@ int main(int argc, char* argv[]) {
 	in.SetRefereeIncompatibilityWeight(ri);
 	in.SetTeamIncompatibilityWeight(ti);
 
-	EnumerationRAOpt solver(in);
-
+	bool hasSolution;
 	auto start = high_resolution_clock::now();
-	bool hasSolution = solver.Search();
-	auto stop = high_resolution_clock::now();
+	auto stop = start;
+
+	if (threads > 1) {
+		ParallelEnumerationOpt<RA_Input, RA_Output, int> solver([&]() { return new EnumerationRAOpt(in); }, threads, prefixLength);
+
+		start = high_resolution_clock::now();
+		hasSolution = solver.Search();
+		stop = high_resolution_clock::now();
+		if (hasSolution)
+			cout << "Best solution found" << endl << solver.BestSolution()
+				 << " (cost " << solver.BestCost() << ") after  " << solver.NumSol()
+				 << " iterations" << endl;
+		else
+			cout << "No solution exists" << endl;
+		cout << solver.NumPrefixes() << " prefixes of " << prefixLength << " games" << endl;
+		for (unsigned w = 0; w < solver.NumWorkers(); w++)
+			cout << "Worker " << w << ": " << solver.WorkerSol(w) << " iterations, " << solver.WorkerPrefixes(w) << " prefixes" << endl;
+	} else {
+		EnumerationRAOpt solver(in);
+
+		start = high_resolution_clock::now();
+		hasSolution = solver.Search();
+		stop = high_resolution_clock::now();
+		if (hasSolution)
+			cout << "Best solution found" << endl << solver.BestSolution()
+				 << " (cost " << solver.BestCost() << ") after  " << solver.NumSol()
+				 << " iterations" << endl;
+		else
+			cout << "No solution exists" << endl;
+	}
 	auto duration = stop - start;
-	if (hasSolution)
-    	cout << "Best solution found" << endl << solver.BestSolution()
-        	 << " after  " << solver.NumSol() 
-        	 << " iterations" << endl;
-  	else
-    	cout << "No solution exists" << endl;
-    cout << "Elapsed time: " << duration_cast<milliseconds>(duration).count() / 1000.0 << " s" << endl;
-  	return 0;
+	cout << "Elapsed time: " << duration_cast<milliseconds>(duration).count() / 1000.0 << " s" << endl;
+	return 0;
 }
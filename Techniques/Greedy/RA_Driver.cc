@@ -6,11 +6,12 @@
 #include <string>
 #include "RA_Data.hh"
 #include "RA_Greedy.hh"
+#include "Random.hh"
 
 using namespace std::chrono;
 
 int main(int argc, char* argv[]) {
-	string instance;
+	string instance, mode = "shuffle";
 	int loe, gd, td, o, af, ri, ti;	// soft constraints weights
 
 	if (argc == 1) {
@@ -46,7 +47,7 @@ int main(int argc, char* argv[]) {
   		cin >> ri;
   		cout << "TeamIncompatibility weight: ";
   		cin >> ti;
-  	} else if (argc == 9) {
+  	} else if (argc >= 9 && argc <= 11) {
   		instance = argv[1];
   		loe = stoi(argv[2]);
   		gd = stoi(argv[3]);
@@ -55,12 +56,18 @@ int main(int argc, char* argv[]) {
   		af = stoi(argv[6]);
   		ri = stoi(argv[7]);
   		ti = stoi(argv[8]);
+  		if (argc >= 10)
+  			mode = argv[9];
+  		if (argc == 11) {	// fixed seed, for reproducible runs
+  			srand(stoul(argv[10]));
+  			SetRandomSeed(stoul(argv[10]));
+  		}
 	} else {
-		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti]]" << endl;
+		cerr << "Usage: " << argv[0] << " [input_file [loe gd td o af ri ti [shuffle|lazy|regret [seed]]]]" << endl;
       	exit(1);
 	}
 
-	RA_Input in(instance);
+	RA_Input in = ReadInstance(instance);
 
   	in.SetLackOfExperienceWeight(loe);
 	in.SetGamesDistributionWeight(gd);
@@ -73,7 +80,16 @@ int main(int argc, char* argv[]) {
 	RA_Output out(in);
 
 	auto start = high_resolution_clock::now();
-	GreedyRASolver(in, out);
+	if (mode == "shuffle")
+		GreedyRASolver(in, out);
+	else if (mode == "lazy")
+		GreedyRALazySolver(in, out);
+	else if (mode == "regret")
+		GreedyRARegretSolver(in, out);
+	else {
+		cerr << "Unknown greedy mode " << mode << endl;
+		exit(1);
+	}
 	auto stop = high_resolution_clock::now();
 	auto duration = stop - start;
 
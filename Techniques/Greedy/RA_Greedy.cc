@@ -4,9 +4,43 @@
 #include <algorithm>
 #include <iterator>
 #include <vector>
+#include <queue>
+#include <tuple>
+#include <stdexcept>
 #include "RA_Greedy.hh"
 #include "Random.hh"
 
+/*	Soft cost variation of the assignment of the referee r to the game, given
+	the current partial solution. Returns false if the assignment violates a
+	hard constraint on the referee (travel distance, availability, level).
+*/
+static bool CandidateDeltaCost(const RA_Input& in, const RA_Output& out, int game, int r, int& deltaCost) {
+	const set<int>& oldAssignedReferees = out.AssignedReferees(game);
+	set<int> newAssignedReferees(oldAssignedReferees);
+
+	newAssignedReferees.insert(r);
+
+	if (FeasibleTravelDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
+		return false;
+
+	if (RefereeAvailabilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
+		return false;
+
+	if (MinimumLevelDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
+		return false;
+
+	deltaCost = 0;
+	deltaCost += in.LackOfExperienceWeight() * LackOfExperienceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.GamesDistributionWeight() * GamesDistributionDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.TotalDistanceWeight() * TotalDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.OptionalRefereeWeight() * OptionalRefereeDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.AssignmentFrequencyWeight() * AssignmentFrequencyDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.RefereeIncompatibilityWeight() * RefereeIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+	deltaCost += in.TeamIncompatibilityWeight() * TeamIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+
+	return true;
+}
+
 /*	Greedy steps:
 	(1)	Randomly choose the first game g to be assigned
 	(2)	If the number of referees assigned to g is less than the maximum number of
@@ -20,30 +54,47 @@
       processed
 	(4)	Repeat the previous steps until at least one referee is assigned to a game
 
+	With alpha > 0 the choice of (2.1.1) and (2.1.2) is randomized (GRASP): the
+	referee is taken uniformly from the restricted candidate list, i.e. the
+	referees whose delta is within min + alpha * (max - min) of the candidates
+	(alpha = 1 is a random feasible choice, alpha = 0 the plain greedy). With
+	k > 0 the list keeps at most the k cheapest of them.
+
 	Required invariant: at each referee assignment hard constraints are NOT violated, except
 						for the minimum number of referees, of course.
 */
-void GreedyRASolver(const RA_Input& in, RA_Output& out) {
-	bool hasAssigned;
-	int deltaCost, minDeltaCost, assignReferee, equalMinDeltaNum;
-	set<int> oldAssignedReferees, newAssignedReferees, referees, diffReferees;
-	set<int>::iterator rbeg, rend, abeg, aend;
+void GreedyRASolver(const RA_Input& in, RA_Output& out, double alpha, int k) {
 	vector<int> games;
 
 	for (int g = 1; g <= in.NumGames(); g++)
 		games.push_back(g);
 
+	out.Reset();
+
+	GreedyRARepair(in, out, games, alpha, k);
+}
+
+/*	Partial greedy: the steps above are applied only to the given games, the
+	assignments of all the other games (and the referees already assigned to
+	the given games) are kept fixed. Returns the (weighted) soft cost variation.
+*/
+int GreedyRARepair(const RA_Input& in, RA_Output& out, vector<int>& games, double alpha, int k) {
+	bool hasAssigned;
+	bool restricted = alpha > 0.0 || k > 0;
+	int deltaCost, minDeltaCost, maxDeltaCost, assignReferee, equalMinDeltaNum, totalDeltaCost = 0;
+	set<int> referees, diffReferees;
+	vector<pair<int, int>> candidates;	// (referee, delta) of the feasible referees, for the restricted candidate list
+	set<int>::iterator rbeg, rend, abeg, aend;
+
 	for (int r = 1; r <= in.NumReferees(); r++)
 		referees.insert(r);
 
 	rbeg = referees.begin();
 	rend = referees.end();
 
-	out.Reset();
-
 	do {
 		hasAssigned = false;
-		random_shuffle(games.begin(), games.end());
+		RandomShuffle(games);
 
 		for (int game : games) {
 			const Division &division = in.GetDivision(in.GetGame(game).Division());
@@ -57,33 +108,22 @@ void GreedyRASolver(const RA_Input& in, RA_Output& out) {
     			else
     				minDeltaCost = 0;
 
+    			maxDeltaCost = INT_MIN;
+    			candidates.clear();
     			diffReferees.clear();
     			abeg = out.AssignedReferees(game).begin();
     			aend = out.AssignedReferees(game).end();
     			set_difference(rbeg, rend, abeg, aend, inserter(diffReferees, diffReferees.end()));
 
 				for (int r : diffReferees) {
-					oldAssignedReferees = out.AssignedReferees(game);
-					newAssignedReferees = out.AssignedReferees(game);
-  					newAssignedReferees.insert(r);
-
-					if (FeasibleTravelDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
-    					continue;
-
-  					if (RefereeAvailabilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
-    					continue;
+					if (!CandidateDeltaCost(in, out, game, r, deltaCost))
+						continue;
 
-  					if (MinimumLevelDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees) > 0)
-    					continue;
-
-    				deltaCost = 0;
-    				deltaCost += in.LackOfExperienceWeight() * LackOfExperienceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.GamesDistributionWeight() * GamesDistributionDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.TotalDistanceWeight() * TotalDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.OptionalRefereeWeight() * OptionalRefereeDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.AssignmentFrequencyWeight() * AssignmentFrequencyDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.RefereeIncompatibilityWeight() * RefereeIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
-    				deltaCost += in.TeamIncompatibilityWeight() * TeamIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+					// the optional referees are candidates only if they improve the cost
+					if (restricted && (static_cast<int>(out.AssignedReferees(game).size()) < division.MinReferees() || deltaCost < 0)) {
+						candidates.push_back(make_pair(r, deltaCost));
+						maxDeltaCost = max(maxDeltaCost, deltaCost);
+					}
 
     				if (deltaCost < minDeltaCost) {
     					minDeltaCost = deltaCost;
@@ -97,14 +137,283 @@ void GreedyRASolver(const RA_Input& in, RA_Output& out) {
     				}
 				}
 
+				if (assignReferee != 0 && restricted && !candidates.empty()) {
+					int threshold = minDeltaCost + static_cast<int>(alpha * (maxDeltaCost - minDeltaCost));
+
+					candidates.erase(remove_if(candidates.begin(), candidates.end(),
+						[threshold](const pair<int, int>& c) { return c.second > threshold; }), candidates.end());
+					if (k > 0 && static_cast<int>(candidates.size()) > k) {
+						nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(),
+							[](const pair<int, int>& c1, const pair<int, int>& c2) { return c1.second < c2.second; });
+						candidates.resize(k);
+					}
+					tie(assignReferee, minDeltaCost) = candidates[Random(0, static_cast<int>(candidates.size()) - 1)];
+				}
+
 				if (assignReferee != 0) {
 					out.Assign(assignReferee, game);
+					totalDeltaCost += minDeltaCost;
 					hasAssigned = true;
 				}
 			}
 		}
 
 	} while (hasAssigned);
+
+	return totalDeltaCost;
+}
+
+/*	Lazy greedy: the same passes of the greedy above, but each game keeps only
+	its best candidate referee and the delta of it, found by a scan of the
+	referees. At the next visits only the delta of that candidate is
+	recomputed: if it has not grown the candidate is still taken, otherwise
+	(or when the game is marked stale) the referees are scanned again.
+	After the assignment of r to g the game g is marked stale, and the delta
+	of r alone is recomputed for the games whose delta of r the assignment
+	changes, i.e. the games of the dates around the one of g (travel distance
+	and availability) and the games of the teams of g (assignment frequency):
+	r becomes their candidate if it is now cheaper, and the games whose
+	candidate was r are marked stale. A pass costs then one evaluation per
+	game, and a scan of the referees only for the games assigned or touched,
+	instead of a scan for every game. The deltas of the other referees in the
+	untouched games may drift (the games distribution depends on the loads of
+	all the referees), and they are refreshed only at the next scan.
+	Returns the (weighted) soft cost variation.
+*/
+int GreedyRALazyRepair(const RA_Input& in, RA_Output& out, vector<int>& games) {
+	vector<int> bestReferee(in.NumGames() + 1, 0), bestDelta(in.NumGames() + 1, 0), touchedAt(in.NumGames() + 1, 0);
+	vector<bool> selected(in.NumGames() + 1, false), stale(in.NumGames() + 1, true);
+	bool hasAssigned;
+	int deltaCost, assignments = 0, totalDeltaCost = 0;
+
+	// the candidate of a game that has its mandatory referees must improve the cost (0 if there is none)
+	auto Scan = [&](int game) {
+		const set<int>& assignedReferees = out.AssignedReferees(game);
+		int equalMinDeltaNum = 1;
+
+		bestReferee[game] = 0;
+		bestDelta[game] = static_cast<int>(assignedReferees.size()) < in.GetDivision(in.GetGame(game).Division()).MinReferees() ? INT_MAX : 0;
+		for (int r = 1; r <= in.NumReferees(); r++) {
+			if (assignedReferees.find(r) != assignedReferees.end() || !CandidateDeltaCost(in, out, game, r, deltaCost))
+				continue;
+			if (deltaCost < bestDelta[game]) {
+				bestDelta[game] = deltaCost;
+				bestReferee[game] = r;
+				equalMinDeltaNum = 1;
+			} else if (deltaCost == bestDelta[game] && bestReferee[game] != 0 && Random(1, ++equalMinDeltaNum) == 1)
+				bestReferee[game] = r;
+		}
+		stale[game] = false;
+	};
+
+	for (int g : games)
+		selected[g] = true;
+
+	do {
+		hasAssigned = false;
+		RandomShuffle(games);
+
+		for (int game : games) {
+			const Division &division = in.GetDivision(in.GetGame(game).Division());
+
+			if (static_cast<int>(out.AssignedReferees(game).size()) >= division.MaxReferees())
+				continue;
+
+			if (!stale[game] && bestReferee[game] != 0) {
+				if (CandidateDeltaCost(in, out, game, bestReferee[game], deltaCost) && deltaCost <= bestDelta[game])
+					bestDelta[game] = deltaCost;
+				else
+					stale[game] = true;
+			}
+			if (stale[game])
+				Scan(game);
+
+			int assignReferee = bestReferee[game];
+
+			if (assignReferee == 0)
+				continue;
+
+			out.Assign(assignReferee, game);
+			totalDeltaCost += bestDelta[game];
+			hasAssigned = true;
+			stale[game] = true;
+			assignments++;
+
+			auto Touch = [&](int g) {
+				if (!selected[g] || stale[g] || touchedAt[g] == assignments || out.AssignedReferees(g).find(assignReferee) != out.AssignedReferees(g).end())
+					return;
+				touchedAt[g] = assignments;
+				if (bestReferee[g] == assignReferee)
+					stale[g] = true;
+				else if (CandidateDeltaCost(in, out, g, assignReferee, deltaCost) && deltaCost < bestDelta[g]) {
+					bestReferee[g] = assignReferee;
+					bestDelta[g] = deltaCost;
+				}
+			};
+			int firstDate = max(in.DateOf(game) - 1, 1), lastDate = min(in.DateOf(game) + 1, in.NumDates());
+
+			for (int g = in.FirstGameOfDate(firstDate); g < in.FirstGameOfDate(lastDate + 1); g++)
+				Touch(g);
+			for (int g : in.TeamGames(in.GetGame(game).HomeTeam()))
+				Touch(g);
+			for (int g : in.TeamGames(in.GetGame(game).AwayTeam()))
+				Touch(g);
+		}
+
+	} while (hasAssigned);
+
+	return totalDeltaCost;
+}
+
+void GreedyRALazySolver(const RA_Input& in, RA_Output& out) {
+	vector<int> games;
+
+	for (int g = 1; g <= in.NumGames(); g++)
+		games.push_back(g);
+
+	out.Reset();
+
+	GreedyRALazyRepair(in, out, games);
+}
+
+/*	Regret-k greedy: the mandatory slots are filled first, always in the game
+	whose regret is the largest, i.e. the game that would lose the most if its
+	best candidate were taken by another game. The regret of a game is the
+	gap between the delta of its best candidate and the delta of its k-th
+	best one; the games with less than k candidates come first, the fewer
+	the candidates the sooner (a game with no candidate is left unfilled).
+	The candidate deltas of each game are kept in a row, and after the
+	assignment of r to g only the row of g and the entry of r in the games of
+	the dates around the one of g (the only ones whose feasibility can change)
+	are updated, moving those games in the queue. The other entries may
+	drift (e.g. GamesDistribution), hence the row of the game on top of the
+	queue is recomputed before its assignment, and the game is put back if it
+	is no longer the one with the largest regret.
+	The optional slots are then filled by the lazy greedy above.
+	Returns the (weighted) soft cost variation. Throws invalid_argument if
+	k < 2 (with k = 1 the regret is 0 everywhere).
+*/
+int GreedyRARegretRepair(const RA_Input& in, RA_Output& out, vector<int>& games, int k) {
+	typedef tuple<int, int, int, int, int> Entry;	// (shortage, regret, random tie-break, game, version)
+	const int noCandidate = INT_MAX;
+	vector<vector<int>> delta(in.NumGames() + 1);
+	vector<int> version(in.NumGames() + 1, 0), evaluatedAt(in.NumGames() + 1, -1);
+	vector<bool> open(in.NumGames() + 1, false);
+	priority_queue<Entry> queue;
+	int assignments = 0, deltaCost, totalDeltaCost = 0;
+
+	if (k < 2)
+		throw invalid_argument("the regret greedy needs k >= 2, not " + to_string(k));
+
+	auto Short = [&](int g) {
+		return static_cast<int>(out.AssignedReferees(g).size()) < in.GetDivision(in.GetGame(g).Division()).MinReferees();
+	};
+
+	// the partial solution only grows, hence a referee that is assigned or infeasible stays so
+	auto Evaluate = [&](int g, int r) {
+		if (delta[g][r] == noCandidate)
+			return;
+		if (out.AssignedReferees(g).find(r) != out.AssignedReferees(g).end() || !CandidateDeltaCost(in, out, g, r, deltaCost))
+			delta[g][r] = noCandidate;
+		else
+			delta[g][r] = deltaCost;
+	};
+
+	// pushes the game with its current regret, returns false if the game has no candidate
+	auto Push = [&](int g) {
+		vector<int> best;
+
+		for (int r = 1; r <= in.NumReferees(); r++)
+			if (delta[g][r] != noCandidate) {
+				best.push_back(delta[g][r]);
+				if (static_cast<int>(best.size()) > k) {
+					nth_element(best.begin(), best.begin() + k, best.end());
+					best.pop_back();
+				}
+			}
+
+		if (best.empty())
+			return false;
+
+		sort(best.begin(), best.end());
+		queue.push(make_tuple(k - static_cast<int>(best.size()), best.back() - best.front(), Random(0, INT_MAX), g, ++version[g]));
+		return true;
+	};
+
+	for (int g : games)
+		if (Short(g)) {
+			open[g] = true;
+			delta[g].assign(in.NumReferees() + 1, 0);
+			for (int r = 1; r <= in.NumReferees(); r++)
+				Evaluate(g, r);
+			evaluatedAt[g] = assignments;
+			open[g] = Push(g);
+		}
+
+	while (!queue.empty()) {
+		int game = get<3>(queue.top()), assignReferee = 0, equalMinDeltaNum = 1;
+		Entry entry = queue.top();
+
+		queue.pop();
+		if (!open[game] || get<4>(entry) != version[game])
+			continue;	// outdated entry
+
+		if (evaluatedAt[game] < assignments) {	// the row may have drifted, it is recomputed
+			for (int r = 1; r <= in.NumReferees(); r++)
+				Evaluate(game, r);
+			evaluatedAt[game] = assignments;
+			if (!(open[game] = Push(game)))
+				continue;
+			while (!queue.empty() && get<4>(queue.top()) != version[get<3>(queue.top())])
+				queue.pop();
+			if (get<3>(queue.top()) != game)
+				continue;	// another game has now a larger regret
+			queue.pop();
+		}
+
+		for (int r = 1; r <= in.NumReferees(); r++)
+			if (delta[game][r] != noCandidate) {
+				if (assignReferee == 0 || delta[game][r] < delta[game][assignReferee]) {
+					assignReferee = r;
+					equalMinDeltaNum = 1;
+				} else if (delta[game][r] == delta[game][assignReferee] && Random(1, ++equalMinDeltaNum) == 1)
+					assignReferee = r;
+			}
+
+		out.Assign(assignReferee, game);
+		totalDeltaCost += delta[game][assignReferee];
+		assignments++;
+
+		if (Short(game)) {
+			for (int r = 1; r <= in.NumReferees(); r++)
+				Evaluate(game, r);
+			evaluatedAt[game] = assignments;
+			open[game] = Push(game);
+		} else
+			open[game] = false;
+
+		// the referee may no longer be feasible (or may be cheaper) for the games around the date
+		int firstDate = max(in.DateOf(game) - 1, 1), lastDate = min(in.DateOf(game) + 1, in.NumDates());
+
+		for (int g = in.FirstGameOfDate(firstDate); g < in.FirstGameOfDate(lastDate + 1); g++)
+			if (open[g] && g != game) {
+				Evaluate(g, assignReferee);
+				open[g] = Push(g);
+			}
+	}
+
+	return totalDeltaCost + GreedyRALazyRepair(in, out, games);
+}
+
+void GreedyRARegretSolver(const RA_Input& in, RA_Output& out, int k) {
+	vector<int> games;
+
+	for (int g = 1; g <= in.NumGames(); g++)
+		games.push_back(g);
+
+	out.Reset();
+
+	GreedyRARegretRepair(in, out, games, k);
 }
 
 /***************************************************************************
@@ -395,34 +704,33 @@ int GamesDistributionDeltaCost(const RA_Input& in, const RA_Output& out, int gam
   set<int>::iterator nend = newAssignedReferees.end();
   int numAssignedReferees = static_cast<int>(oldAssignedReferees.size());
   int numNewAssignedReferees = static_cast<int>(newAssignedReferees.size());
-  int oldTotalAssignedGames = 0, newTotalAssignedGames;
+  int oldTotalAssignedGames = out.TotalAssignments(), newTotalAssignedGames;
   double oldAverageAssignedGames, newAverageAssignedGames;
-  int oldGamesDistribution, newGamesDistribution;
+  const vector<int>& loads = out.RefereeLoads();
 
   set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
   set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
 
-  for (int r = 1; r <= in.NumReferees(); r++)
-    oldTotalAssignedGames += out.AssignedGames(r).size();
-
   newTotalAssignedGames = oldTotalAssignedGames + (numNewAssignedReferees - numAssignedReferees);
   oldAverageAssignedGames = static_cast<double>(oldTotalAssignedGames) / in.NumReferees();
   newAverageAssignedGames = static_cast<double>(newTotalAssignedGames) / in.NumReferees();
 
-  for (int r = 1; r <= in.NumReferees(); r++)
-  {
-    oldGamesDistribution = static_cast<int>(ceil(fabs(oldAverageAssignedGames - out.AssignedGames(r).size())));
+  // the shift of the average, for all the referees with the same number of games at once
+  if (newTotalAssignedGames != oldTotalAssignedGames)
+    for (unsigned n = 0; n < loads.size(); n++)
+      if (loads[n] > 0)
+        cost += loads[n] * (static_cast<int>(ceil(fabs(newAverageAssignedGames - n))) - static_cast<int>(ceil(fabs(oldAverageAssignedGames - n))));
 
-    if (oldDiffReferees.find(r) != oldDiffReferees.end() &&
-        newDiffReferees.find(r) == newDiffReferees.end())
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - (out.AssignedGames(r).size() - 1))));
-    else if (newDiffReferees.find(r) != newDiffReferees.end() &&
-             oldDiffReferees.find(r) == oldDiffReferees.end())
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - (out.AssignedGames(r).size() + 1))));
-    else
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - out.AssignedGames(r).size())));
-
-    cost += newGamesDistribution - oldGamesDistribution;
+  // the referees whose number of games changes
+  for (int r : oldDiffReferees)
+  {
+    int n = out.AssignedGames(r).size();
+    cost += static_cast<int>(ceil(fabs(newAverageAssignedGames - (n - 1)))) - static_cast<int>(ceil(fabs(newAverageAssignedGames - n)));
+  }
+  for (int r : newDiffReferees)
+  {
+    int n = out.AssignedGames(r).size();
+    cost += static_cast<int>(ceil(fabs(newAverageAssignedGames - (n + 1)))) - static_cast<int>(ceil(fabs(newAverageAssignedGames - n)));
   }
 
   return cost;
@@ -560,8 +868,6 @@ int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_Output& out, int g
   set<int>::iterator nend = newAssignedReferees.end();
   int numAssignedReferees = static_cast<int>(oldAssignedReferees.size());
   int numNewAssignedReferees = static_cast<int>(newAssignedReferees.size());
-  int mvgHomeTeamCode = in.GetTeam(in.GetGame(game).HomeTeam()).Code();
-  int mvgAwayTeamCode = in.GetTeam(in.GetGame(game).AwayTeam()).Code();
   int oldmvgHTTotalAssignedReferees = 0, oldmvgATTotalAssignedReferees = 0;
   int newmvgHTTotalAssignedReferees, newmvgATTotalAssignedReferees;
   int mvgHTAssignedInputReferee = 0, mvgATAssignedInputReferee = 0;
@@ -573,34 +879,34 @@ int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_Output& out, int g
   set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
   set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
 
-  for (int r = 1; r <= in.NumReferees(); r++)
+  // the games of the two teams are scanned once, counting how many times each referee is assigned to them
+  vector<int> mvgHTAssignedReferee(in.NumReferees() + 1, 0), mvgATAssignedReferee(in.NumReferees() + 1, 0);
+
+  for (int g : in.TeamGames(in.GetGame(game).HomeTeam()))
   {
-    for (int g = 1; g <= in.NumGames(); g++)
-    {
-      const Team &homeTeam = in.GetTeam(in.GetGame(g).HomeTeam());
-      const Team &awayTeam = in.GetTeam(in.GetGame(g).AwayTeam());
+    oldmvgHTTotalAssignedReferees += out.AssignedReferees(g).size();
+    for (int r : out.AssignedReferees(g))
+      mvgHTAssignedReferee[r]++;
+  }
 
-      if (mvgHomeTeamCode == homeTeam.Code() || mvgHomeTeamCode == awayTeam.Code())
-      {
-        oldmvgHTTotalAssignedReferees += out.AssignedReferees(g).size();
-        if (out.AssignedReferees(g).find(r) != out.AssignedReferees(g).end())
-          mvgHTAssignedInputReferee++;
-      }
+  for (int g : in.TeamGames(in.GetGame(game).AwayTeam()))
+  {
+    oldmvgATTotalAssignedReferees += out.AssignedReferees(g).size();
+    for (int r : out.AssignedReferees(g))
+      mvgATAssignedReferee[r]++;
+  }
 
-      if (mvgAwayTeamCode == homeTeam.Code() || mvgAwayTeamCode == awayTeam.Code())
-      {
-        oldmvgATTotalAssignedReferees += out.AssignedReferees(g).size();
-        if (out.AssignedReferees(g).find(r) != out.AssignedReferees(g).end())
-          mvgATAssignedInputReferee++;
-      }
-    }
+  newmvgHTTotalAssignedReferees = oldmvgHTTotalAssignedReferees + (numNewAssignedReferees - numAssignedReferees);
+  newmvgATTotalAssignedReferees = oldmvgATTotalAssignedReferees + (numNewAssignedReferees - numAssignedReferees);
+  oldmvgHTAverageAssignedReferee = static_cast<double>(oldmvgHTTotalAssignedReferees) / in.NumReferees();
+  newmvgHTAverageAssignedReferee = static_cast<double>(newmvgHTTotalAssignedReferees) / in.NumReferees();
+  oldmvgATAverageAssignedReferee = static_cast<double>(oldmvgATTotalAssignedReferees) / in.NumReferees();
+  newmvgATAverageAssignedReferee = static_cast<double>(newmvgATTotalAssignedReferees) / in.NumReferees();
 
-    newmvgHTTotalAssignedReferees = oldmvgHTTotalAssignedReferees + (numNewAssignedReferees - numAssignedReferees);
-    newmvgATTotalAssignedReferees = oldmvgATTotalAssignedReferees + (numNewAssignedReferees - numAssignedReferees);
-    oldmvgHTAverageAssignedReferee = static_cast<double>(oldmvgHTTotalAssignedReferees) / in.NumReferees();
-    newmvgHTAverageAssignedReferee = static_cast<double>(newmvgHTTotalAssignedReferees) / in.NumReferees();
-    oldmvgATAverageAssignedReferee = static_cast<double>(oldmvgATTotalAssignedReferees) / in.NumReferees();
-    newmvgATAverageAssignedReferee = static_cast<double>(newmvgATTotalAssignedReferees) / in.NumReferees();
+  for (int r = 1; r <= in.NumReferees(); r++)
+  {
+    mvgHTAssignedInputReferee = mvgHTAssignedReferee[r];
+    mvgATAssignedInputReferee = mvgATAssignedReferee[r];
 
     if (mvgHTAssignedInputReferee > oldmvgHTAverageAssignedReferee)
       oldmvgHTAssignmentFrequency = static_cast<int>(ceil(mvgHTAssignedInputReferee - oldmvgHTAverageAssignedReferee));
@@ -653,11 +959,6 @@ int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_Output& out, int g
 
     cost += newmvgHTAssignmentFrequency - oldmvgHTAssignmentFrequency;
     cost += newmvgATAssignmentFrequency - oldmvgATAssignmentFrequency;
-
-    oldmvgHTTotalAssignedReferees = 0;
-    oldmvgATTotalAssignedReferees = 0;
-    mvgHTAssignedInputReferee = 0;
-    mvgATAssignedInputReferee = 0;
   }
 
   return cost;
@@ -665,90 +966,35 @@ int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_Output& out, int g
 
 int RefereeIncompatibilityDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees)
 {
-  int cost = 0;
-  set<int> oldDiffReferees, newDiffReferees;
-  set<int>::iterator itI, itJ, itF;
-  set<int>::iterator obeg = oldAssignedReferees.begin();
-  set<int>::iterator oend = oldAssignedReferees.end();
-  set<int>::iterator nbeg = newAssignedReferees.begin();
-  set<int>::iterator nend = newAssignedReferees.end();
+  const IncompatibilityMatrix &incompatibilities = in.RefereeIncompatibilities();
 
-  set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
-  set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
-
-  for (itI = oldDiffReferees.begin(); itI != oldDiffReferees.end(); ++itI)
-  {
-    for (itJ = obeg; itJ != oend; ++itJ)
-    {
-      const Referee &refereeI = in.GetReferee(*itI);
-      const Referee &refereeJ = in.GetReferee(*itJ);
-        
-      if (refereeI.IncompatibleReferee(refereeJ.Code()))
-        cost--;
-
-      itF = oldDiffReferees.find(refereeJ.Code());
-
-      if (itF == oldDiffReferees.end() && refereeJ.IncompatibleReferee(refereeI.Code()))
-        cost--;
-    }
-  }
-
-  for (itI = newDiffReferees.begin(); itI != newDiffReferees.end(); ++itI)
-  {
-    for (itJ = nbeg; itJ != nend; ++itJ)
-    {
-      const Referee &refereeI = in.GetReferee(*itI);
-      const Referee &refereeJ = in.GetReferee(*itJ);
-        
-      if (refereeI.IncompatibleReferee(refereeJ.Code()))
-        cost++;
-
-      itF = newDiffReferees.find(refereeJ.Code());
-
-      if (itF == newDiffReferees.end() && refereeJ.IncompatibleReferee(refereeI.Code()))
-        cost++;
-    }
-  }
-
-  return cost;
+  return incompatibilities.CountPairs(newAssignedReferees) - incompatibilities.CountPairs(oldAssignedReferees);
 }
 
 int TeamIncompatibilityDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees)
 {
-  int cost = 0;
-  set<int> oldDiffReferees, newDiffReferees;
-  set<int>::iterator it;
-  set<int>::iterator obeg = oldAssignedReferees.begin();
-  set<int>::iterator oend = oldAssignedReferees.end();
-  set<int>::iterator nbeg = newAssignedReferees.begin();
-  set<int>::iterator nend = newAssignedReferees.end();
-  const Team &homeTeam = in.GetTeam(in.GetGame(game).HomeTeam());
-  const Team &awayTeam = in.GetTeam(in.GetGame(game).AwayTeam());
-
-  set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
-  set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
+  const IncompatibilityMatrix &incompatibilities = in.TeamIncompatibilities();
+  const Game &g = in.GetGame(game);
 
-  for (it = oldDiffReferees.begin(); it != oldDiffReferees.end(); ++it)
-  {
-    const Referee &referee = in.GetReferee(*it);
-
-    if (referee.IncompatibleTeam(homeTeam.Code()))
-      cost--;
-
-    if (referee.IncompatibleTeam(awayTeam.Code()))
-      cost--;
-  }
-
-  for (it = newDiffReferees.begin(); it != newDiffReferees.end(); ++it)
-  {
-    const Referee &referee = in.GetReferee(*it);
-
-    if (referee.IncompatibleTeam(homeTeam.Code()))
-      cost++;
-
-    if (referee.IncompatibleTeam(awayTeam.Code()))
-      cost++;
-  }
+  return incompatibilities.Count(g.HomeTeam(), newAssignedReferees) + incompatibilities.Count(g.AwayTeam(), newAssignedReferees)
+    - incompatibilities.Count(g.HomeTeam(), oldAssignedReferees) - incompatibilities.Count(g.AwayTeam(), oldAssignedReferees);
+}
 
-  return cost;
+void AssignmentDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees, int& deltaViolations, int& deltaCost)
+{
+  deltaViolations = 0;
+  deltaViolations += MinimumRefereesDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaViolations += MaximumRefereesDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaViolations += FeasibleTravelDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaViolations += RefereeAvailabilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaViolations += MinimumLevelDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+
+  deltaCost = 0;
+  deltaCost += in.LackOfExperienceWeight() * LackOfExperienceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.GamesDistributionWeight() * GamesDistributionDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.TotalDistanceWeight() * TotalDistanceDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.OptionalRefereeWeight() * OptionalRefereeDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.AssignmentFrequencyWeight() * AssignmentFrequencyDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.RefereeIncompatibilityWeight() * RefereeIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
+  deltaCost += in.TeamIncompatibilityWeight() * TeamIncompatibilityDeltaCost(in, out, game, oldAssignedReferees, newAssignedReferees);
 }
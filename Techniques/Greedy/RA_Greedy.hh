@@ -4,7 +4,12 @@
 #define RA_GREEDY_HH
 #include "RA_Data.hh"
 
-void GreedyRASolver(const RA_Input& in, RA_Output& out);
+void GreedyRASolver(const RA_Input& in, RA_Output& out, double alpha = 0.0, int k = 0);	// alpha > 0 or k > 0: random choice in the restricted candidate list (of at most k referees)
+int GreedyRARepair(const RA_Input& in, RA_Output& out, vector<int>& games, double alpha = 0.0, int k = 0);	// assigns referees only to the given games, the other assignments are fixed
+void GreedyRALazySolver(const RA_Input& in, RA_Output& out);	// same greedy criterion, each game keeps its best candidate and is rescanned only when it is stale
+int GreedyRALazyRepair(const RA_Input& in, RA_Output& out, vector<int>& games);
+void GreedyRARegretSolver(const RA_Input& in, RA_Output& out, int k = 2);	// mandatory slots first, in the game with the largest regret-k (k >= 2)
+int GreedyRARegretRepair(const RA_Input& in, RA_Output& out, vector<int>& games, int k = 2);
 
 /***************************************************************************
  * Delta Cost Support Functions:
@@ -21,5 +26,9 @@ int OptionalRefereeDeltaCost(const RA_Input& in, const RA_Output& out, int game,
 int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees);
 int RefereeIncompatibilityDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees);
 int TeamIncompatibilityDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees);
+// variation of the number of violations and of the (weighted) cost when the referees of the game are changed
+void AssignmentDeltaCost(const RA_Input& in, const RA_Output& out, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees, int& deltaViolations, int& deltaCost);
+// weight of a violation in the objectives that combine violations and cost (matching, LNS)
+const int hardWeight = 1000;
 
 #endif
@@ -0,0 +1,210 @@
+// File RA_Matching.cc
+
+#include <limits>
+#include "RA_Matching.hh"
+#include "RA_Greedy.hh"
+
+MatchingRA::MatchingRA(const RA_Input& i) : in(i) {}
+
+vector<set<int>> MatchingRA::OptimalAssignment(const RA_Output& out, int d) const {
+	const double excluded = 1e12;
+	int first = in.FirstGameOfDate(d), last = in.FirstGameOfDate(d + 1);
+	vector<int> slotGame;
+	vector<double> slotReward;
+
+	for (int g = first; g < last; g++) {
+		const Division &division = in.GetDivision(in.GetGame(g).Division());
+		for (int k = 0; k < division.MaxReferees(); k++) {
+			slotGame.push_back(g);
+			slotReward.push_back(k < division.MinReferees() ? hardWeight : in.OptionalRefereeWeight());
+		}
+	}
+
+	int n = static_cast<int>(slotGame.size());
+	vector<set<int>> newAssignedReferees(last - first);
+
+	if (n == 0)
+		return newAssignedReferees;
+
+	// columns: the referees, then one dummy column per slot (slot left empty, zero cost)
+	vector<vector<double>> a(n, vector<double>(in.NumReferees() + n, 0.0));
+	vector<vector<bool>> eligible(last - first, vector<bool>(in.NumReferees() + 1));
+	vector<vector<double>> edgeCost(last - first, vector<double>(in.NumReferees() + 1));
+
+	for (int g = first; g < last; g++)
+		for (int r = 1; r <= in.NumReferees(); r++) {
+			eligible[g - first][r] = Eligible(out, r, g, first, last);
+			if (eligible[g - first][r])
+				edgeCost[g - first][r] = EdgeCost(r, g);
+		}
+
+	for (int s = 0; s < n; s++)
+		for (int r = 1; r <= in.NumReferees(); r++)
+			if (eligible[slotGame[s] - first][r])
+				a[s][r - 1] = edgeCost[slotGame[s] - first][r] - slotReward[s];
+			else
+				a[s][r - 1] = excluded;
+
+	vector<int> column = MinCostAssignment(a);
+
+	for (int s = 0; s < n; s++)
+		if (column[s] < in.NumReferees())
+			newAssignedReferees[slotGame[s] - first].insert(column[s] + 1);
+
+	return newAssignedReferees;
+}
+
+void MatchingRA::Reassign(RA_Output& out, int d, const vector<set<int>>& newAssignedReferees, int& deltaViolations, int& deltaCost) const {
+	int first = in.FirstGameOfDate(d), last = in.FirstGameOfDate(d + 1);
+	int gameViolations, gameCost;
+
+	deltaViolations = deltaCost = 0;
+
+	for (int g = first; g < last; g++) {
+		set<int> oldAssignedReferees = out.AssignedReferees(g);
+		const set<int>& assignedReferees = newAssignedReferees[g - first];
+
+		if (oldAssignedReferees == assignedReferees)
+			continue;
+
+		AssignmentDeltaCost(in, out, g, oldAssignedReferees, assignedReferees, gameViolations, gameCost);
+		deltaViolations += gameViolations;
+		deltaCost += gameCost;
+
+		out.UnassignAll(g);
+		for (int r : assignedReferees)
+			out.Assign(r, g);
+	}
+}
+
+void MatchingRA::Reassign(RA_Output& out, int d, int& deltaViolations, int& deltaCost) const {
+	Reassign(out, d, OptimalAssignment(out, d), deltaViolations, deltaCost);
+}
+
+int MatchingRA::ImproveDate(RA_Output& out, int d) const {
+	int deltaViolations, deltaCost, restoreViolations, restoreCost;
+	vector<set<int>> oldAssignedReferees;
+
+	for (int g = in.FirstGameOfDate(d); g < in.FirstGameOfDate(d + 1); g++)
+		oldAssignedReferees.push_back(out.AssignedReferees(g));
+
+	Reassign(out, d, deltaViolations, deltaCost);
+
+	if (Objective(deltaViolations, deltaCost) < 0)
+		return -Objective(deltaViolations, deltaCost);
+
+	Reassign(out, d, oldAssignedReferees, restoreViolations, restoreCost);
+	return 0;
+}
+
+int MatchingRA::Polish(RA_Output& out) const {
+	int improvement = 0;
+
+	for (int d = 1; d <= in.NumDates(); d++)
+		improvement += ImproveDate(out, d);
+
+	return improvement;
+}
+
+bool MatchingRA::Eligible(const RA_Output& out, int r, int g, int first, int last) const {
+	const Referee &referee = in.GetReferee(r);
+	const Game &game = in.GetGame(g);
+
+	if (referee.Unavailable(game.Match()))
+		return false;
+
+	if (referee.Level() < in.GetDivision(game.Division()).Level())
+		return false;
+
+	// the last game of the referee before the date and the first one after it
+	const set<int>& assignedGames = out.AssignedGames(r);
+	set<int>::const_iterator itn = assignedGames.lower_bound(first);
+
+	if (itn != assignedGames.begin() && out.OverlappingGames(in.GetGame(*prev(itn)), game, r))
+		return false;
+
+	itn = assignedGames.lower_bound(last);
+
+	if (itn != assignedGames.end() && out.OverlappingGames(game, in.GetGame(*itn), r))
+		return false;
+
+	return true;
+}
+
+double MatchingRA::EdgeCost(int r, int g) const {
+	const Referee &referee = in.GetReferee(r);
+	const Game &game = in.GetGame(g);
+	const Division &division = in.GetDivision(game.Division());
+	double cost = 0.0;
+
+	cost += in.TotalDistanceWeight() * 2.0 * EuclideanDistance(referee.Address(), in.GetArena(game.Arena()).Address());
+
+	if (in.TeamIncompatibilities().Incompatible(game.HomeTeam(), r))
+		cost += in.TeamIncompatibilityWeight();
+	if (in.TeamIncompatibilities().Incompatible(game.AwayTeam(), r))
+		cost += in.TeamIncompatibilityWeight();
+
+	double requiredExperience = static_cast<double>(game.Experience()) / max(division.MinReferees(), 1);
+	if (requiredExperience > referee.Experience())
+		cost += in.LackOfExperienceWeight() * (requiredExperience - referee.Experience()) / requiredExperience;
+
+	return cost;
+}
+
+/*	Hungarian algorithm (shortest augmenting paths with potentials), O(n^2 m).
+	Rows and columns are 1-based internally, p[j] is the row assigned to the column j.
+*/
+vector<int> MinCostAssignment(const vector<vector<double>>& a) {
+	const double inf = numeric_limits<double>::infinity();
+	int n = static_cast<int>(a.size()), m = static_cast<int>(a[0].size());
+	vector<double> u(n + 1, 0.0), v(m + 1, 0.0), minv(m + 1);
+	vector<int> p(m + 1, 0), way(m + 1, 0), column(n);
+	vector<bool> used(m + 1);
+
+	for (int i = 1; i <= n; i++) {
+		int j0 = 0;
+		p[0] = i;
+		fill(minv.begin(), minv.end(), inf);
+		fill(used.begin(), used.end(), false);
+
+		do {
+			int i0 = p[j0], j1 = 0;
+			double delta = inf;
+			used[j0] = true;
+
+			for (int j = 1; j <= m; j++)
+				if (!used[j]) {
+					double cur = a[i0 - 1][j - 1] - u[i0] - v[j];
+					if (cur < minv[j]) {
+						minv[j] = cur;
+						way[j] = j0;
+					}
+					if (minv[j] < delta) {
+						delta = minv[j];
+						j1 = j;
+					}
+				}
+
+			for (int j = 0; j <= m; j++)
+				if (used[j]) {
+					u[p[j]] += delta;
+					v[j] -= delta;
+				} else
+					minv[j] -= delta;
+
+			j0 = j1;
+		} while (p[j0] != 0);
+
+		do {
+			int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		} while (j0 != 0);
+	}
+
+	for (int j = 1; j <= m; j++)
+		if (p[j] != 0)
+			column[p[j] - 1] = j - 1;
+
+	return column;
+}
@@ -0,0 +1,53 @@
+// File RA_Matching.hh
+
+#ifndef RA_MATCHING_HH
+#define RA_MATCHING_HH
+
+#include <vector>
+#include <set>
+#include "RA_Data.hh"
+#include "RA_Greedy.hh"
+
+using namespace std;
+
+/*	Exact reassignment of the games of one date, for a restricted model of it.
+	The assignments of all the other dates are fixed, and every referee is given
+	at most one game of the date: the assignments of a referee to two games of
+	the same date that do not overlap are not reachable by the matching (they
+	are kept only if the new assignment is rejected). Each game offers MaxReferees slots, the first
+	MinReferees of them mandatory, and the referee-to-slot assignment is solved
+	to optimality with the Hungarian algorithm. The cost of an edge is made of
+	the parts of the objective that are linear in the single assignment:
+	- the round trip from the referee's home to the arena (TotalDistance)
+	- the incompatibilities between the referee and the two teams
+	- the share of the required experience not covered by the referee (a proxy of LackOfExperience)
+	- the reward for filling a mandatory (hard) or an optional slot
+	Unavailabilities, insufficient level and overlaps with the games of the
+	neighbouring dates are edge exclusions. The costs that depend on more than
+	one assignment are not in the edges: the incompatibilities between two
+	referees of the same game (RefereeIncompatibility), GamesDistribution and
+	AssignmentFrequency, hence the matching is optimal for the edge costs only.
+	The true cost variation of the new assignment is then evaluated with the
+	delta cost functions, and ImproveDate keeps it only if it improves.
+*/
+class MatchingRA {
+public:
+	MatchingRA(const RA_Input& i);
+	vector<set<int>> OptimalAssignment(const RA_Output& out, int d) const;	// referees of the games of the date d, in the order of the games
+	void Reassign(RA_Output& out, int d, const vector<set<int>>& newAssignedReferees, int& deltaViolations, int& deltaCost) const;
+	void Reassign(RA_Output& out, int d, int& deltaViolations, int& deltaCost) const;	// applies the optimal assignment of the date d
+	int ImproveDate(RA_Output& out, int d) const;	// reassigns the date d only if improving; returns the objective improvement
+	int Polish(RA_Output& out) const;	// reassigns each date, keeping only the improving ones; returns the objective improvement
+	int Objective(int violations, int cost) const { return hardWeight * violations + cost; }
+
+protected:
+	bool Eligible(const RA_Output& out, int r, int g, int first, int last) const;	// false if the edge is excluded
+	double EdgeCost(int r, int g) const;
+
+	const RA_Input& in;
+};
+
+// Hungarian algorithm: a is a n x m cost matrix (n <= m), returns for each row the assigned column
+vector<int> MinCostAssignment(const vector<vector<double>>& a);
+
+#endif
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+mkdir -p LNS_test
+
+for f in ../../RefAssign-Instances/Instances/*.txt
+do
+	s=$(echo "$f" | cut -d'/' -f 5 | cut -d'.' -f 1)
+	timeout 3m ./TestRALNS.exe $f 1 1 1 1 1 1 1 60 &> "./LNS_test/$s-result.txt"
+	echo "LNS: $s-result.txt"
+done
@@ -0,0 +1,237 @@
+// File RA_LNS.cc
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "RA_LNS.hh"
+#include "RA_Greedy.hh"
+#include "Random.hh"
+
+using namespace std::chrono;
+
+LNS_RA::LNS_RA(const RA_Input& i, RA_Output& o)
+	: in(i), out(o), best(i), matching(i), divisionGames(i.NumDivisions()), refereesByDistance(i.NumReferees()), marked(i.NumGames() + 1, false) {
+	for (int g = 1; g <= in.NumGames(); g++)
+		divisionGames[in.GetGame(g).Division() - 1].push_back(g);
+
+	for (int r = 1; r <= in.NumReferees(); r++) {
+		Coordinates2D address = in.GetReferee(r).Address();
+		vector<int>& close = refereesByDistance[r - 1];
+
+		for (int s = 1; s <= in.NumReferees(); s++)
+			close.push_back(s);
+
+		sort(close.begin(), close.end(), [&](int r1, int r2) {
+			return EuclideanDistance(address, in.GetReferee(r1).Address()) < EuclideanDistance(address, in.GetReferee(r2).Address());
+		});
+	}
+}
+
+void LNS_RA::Solve() {
+	auto start = steady_clock::now();
+	int deltaViolations, deltaCost, repairViolations, repairCost;
+	DestroyOperator op;
+
+	GreedyRASolver(in, out);
+	currentViolations = bestViolations = out.ComputeViolations();
+	currentCost = bestCost = out.ComputeCost();
+	SaveBest();
+	temperature = startTemperature;
+	iterations = accepted = 0;
+
+	while (iterations < maxIterations &&
+		   (timeLimit <= 0.0 || duration_cast<duration<double>>(steady_clock::now() - start).count() < timeLimit)) {
+		iterations++;
+		op = static_cast<DestroyOperator>(Random(0, 2));
+
+		if (op == DATE_WINDOW && Random(0.0, 1.0) < matchingRepairRate)
+			MatchingRepair(deltaViolations, deltaCost);
+		else {
+			SelectDestroyed(op);
+			if (destroyed.empty())
+				continue;
+
+			Destroy(deltaViolations, deltaCost);
+			Repair(repairViolations, repairCost);
+			deltaViolations += repairViolations;
+			deltaCost += repairCost;
+		}
+
+		if (Accept(deltaViolations, deltaCost)) {
+			accepted++;
+			currentViolations += deltaViolations;
+			currentCost += deltaCost;
+			RecordAccepted();
+
+			if (Objective(currentViolations, currentCost) < Objective(bestViolations, bestCost)) {
+				SaveBest();
+				bestViolations = currentViolations;
+				bestCost = currentCost;
+			}
+		} else
+			Restore();
+
+		temperature *= coolingRate;
+	}
+
+	RestoreBest();
+}
+
+/*	The journal is bounded by the number of games: beyond that, the best
+	solution is rebuilt once in best (a copy of the current one with the
+	journal undone), and the accepted changes are no longer journaled
+	until the next best solution is found.
+*/
+void LNS_RA::RecordAccepted() {
+	if (bestSaved)
+		return;
+
+	for (unsigned k = 0; k < destroyed.size(); k++)
+		sinceBest.push_back(make_pair(destroyed[k], destroyedReferees[k]));
+
+	if (static_cast<int>(sinceBest.size()) > in.NumGames()) {
+		best = out;
+		UndoSinceBest(best);
+		sinceBest.clear();
+		bestSaved = true;
+	}
+}
+
+void LNS_RA::SaveBest() {
+	sinceBest.clear();
+	bestSaved = false;
+}
+
+void LNS_RA::RestoreBest() {
+	if (bestSaved)
+		out = best;
+	else
+		UndoSinceBest(out);
+	SaveBest();
+}
+
+void LNS_RA::UndoSinceBest(RA_Output& o) const {
+	for (auto it = sinceBest.rbegin(); it != sinceBest.rend(); ++it) {
+		o.UnassignAll(it->first);
+		for (int r : it->second)
+			o.Assign(r, it->first);
+	}
+}
+
+void LNS_RA::SelectDestroyed(DestroyOperator op) {
+	int first, last, d, r;
+
+	destroyed.clear();
+
+	switch (op) {
+		case DATE_WINDOW:
+			// all the games of dateWindow consecutive dates
+			d = Random(1, in.NumDates());
+			first = in.FirstGameOfDate(d);
+			last = in.FirstGameOfDate(min(d + dateWindow, in.NumDates() + 1));
+			for (int g = first; g < last && static_cast<int>(destroyed.size()) < maxDestroyed; g++)
+				destroyed.push_back(g);
+			break;
+
+		case DIVISION:
+		{
+			// all the games of a division (a random block of them, if too many)
+			const vector<int>& games = divisionGames[Random(1, in.NumDivisions()) - 1];
+			if (games.empty())
+				break;
+			first = 0;
+			if (static_cast<int>(games.size()) > maxDestroyed)
+				first = Random(0, static_cast<int>(games.size()) - maxDestroyed);
+			for (int k = first; k < static_cast<int>(games.size()) && static_cast<int>(destroyed.size()) < maxDestroyed; k++)
+				destroyed.push_back(games[k]);
+			break;
+		}
+
+		case CLOSE_REFEREES:
+			// all the games assigned to a referee and to the referees living closest to that referee
+			r = Random(1, in.NumReferees());
+			for (int k = 0; k < closeReferees && k < in.NumReferees(); k++)
+				for (int g : out.AssignedGames(refereesByDistance[r - 1][k])) {
+					if (static_cast<int>(destroyed.size()) >= maxDestroyed)
+						break;
+					if (!marked[g]) {
+						marked[g] = true;
+						destroyed.push_back(g);
+					}
+				}
+			for (int g : destroyed)
+				marked[g] = false;
+			break;
+	}
+}
+
+void LNS_RA::Destroy(int& deltaViolations, int& deltaCost) {
+	set<int> noReferees;
+	int gameViolations, gameCost;
+
+	deltaViolations = deltaCost = 0;
+	destroyedReferees.resize(destroyed.size());
+
+	for (unsigned k = 0; k < destroyed.size(); k++) {
+		int g = destroyed[k];
+		const set<int>& oldAssignedReferees = out.AssignedReferees(g);
+
+		destroyedReferees[k] = oldAssignedReferees;
+		if (oldAssignedReferees.empty())
+			continue;
+
+		AssignmentDeltaCost(in, out, g, oldAssignedReferees, noReferees, gameViolations, gameCost);
+		deltaViolations += gameViolations;
+		deltaCost += gameCost;
+
+		out.UnassignAll(g);
+	}
+}
+
+void LNS_RA::Repair(int& deltaViolations, int& deltaCost) {
+	vector<int> games = destroyed;	// the greedy shuffles the games
+
+	deltaViolations = 0;
+
+	// the partial greedy never violates the hard constraints on the referees,
+	// hence only the minimum number of referees of the repaired games may change
+	for (int g : destroyed)
+		if (!out.HasMinimumReferees(g))
+			deltaViolations--;
+
+	deltaCost = GreedyRARepair(in, out, games);
+
+	for (int g : destroyed)
+		if (!out.HasMinimumReferees(g))
+			deltaViolations++;
+}
+
+void LNS_RA::MatchingRepair(int& deltaViolations, int& deltaCost) {
+	int d = Random(1, in.NumDates());
+
+	destroyed.clear();
+	destroyedReferees.clear();
+	for (int g = in.FirstGameOfDate(d); g < in.FirstGameOfDate(d + 1); g++) {
+		destroyed.push_back(g);
+		destroyedReferees.push_back(out.AssignedReferees(g));
+	}
+
+	matching.Reassign(out, d, deltaViolations, deltaCost);
+}
+
+void LNS_RA::Restore() {
+	for (unsigned k = 0; k < destroyed.size(); k++) {
+		out.UnassignAll(destroyed[k]);
+		for (int r : destroyedReferees[k])
+			out.Assign(r, destroyed[k]);
+	}
+}
+
+bool LNS_RA::Accept(int deltaViolations, int deltaCost) const {
+	int delta = Objective(deltaViolations, deltaCost);
+
+	if (delta <= 0)
+		return true;
+
+	return Random(0.0, 1.0) < exp(-delta / temperature);
+}
@@ -0,0 +1,93 @@
+// File RA_LNS.hh
+
+#ifndef RA_LNS_HH
+#define RA_LNS_HH
+
+#include <vector>
+#include <set>
+#include "RA_Data.hh"
+#include "RA_Matching.hh"
+
+using namespace std;
+
+enum DestroyOperator { DATE_WINDOW, DIVISION, CLOSE_REFEREES };
+
+/*	Large Neighborhood Search:
+	(1)	Build an initial solution with the greedy
+	(2)	Destroy a structured subset of the games (all the games of a window of
+		consecutive dates, all the games of a division, or all the games assigned
+		to a set of geographically close referees), unassigning their referees
+	(3)	Repair the destroyed games with the partial greedy, which keeps fixed the
+		assignments of all the other games; a destroyed single date can instead be
+		reassigned to optimality by the matching (see RA_Matching.hh)
+	(4)	Accept the new solution with the simulated annealing criterion, otherwise
+		restore the destroyed assignments; goto (2) until the iterations are over
+
+	The cost of the current solution is updated through the delta cost functions
+	of the destroyed games only, and the best solution is kept as the journal of
+	the assignments changed since it was found (see RecordAccepted),
+	hence an iteration never scans or copies the whole schedule: its work is the
+	repair of the destroyed games, i.e. O(destroyed * referees) delta evaluations.
+*/
+class LNS_RA {
+public:
+	LNS_RA(const RA_Input& i, RA_Output& o);
+	void Solve();	// the best solution found is left in the output object
+	void SetMaxIterations(long unsigned it) { maxIterations = it; }
+	void SetTimeLimit(double t) { timeLimit = t; }	// in seconds, 0 means no limit
+	void SetStartTemperature(double t) { startTemperature = t; }
+	void SetCoolingRate(double cr) { coolingRate = cr; }
+	void SetMaxDestroyed(int d) { maxDestroyed = d; }
+	void SetDateWindow(int w) { dateWindow = w; }
+	void SetCloseReferees(int r) { closeReferees = r; }
+	void SetMatchingRepairRate(double mr) { matchingRepairRate = mr; }	// probability of a single date destroyed and repaired by the matching
+	long unsigned NumIterations() const { return iterations; }
+	long unsigned NumAccepted() const { return accepted; }
+	int BestCost() const { return bestCost; }
+	int BestViolations() const { return bestViolations; }
+
+protected:
+	void SelectDestroyed(DestroyOperator op);	// fills the destroyed games
+	void Destroy(int& deltaViolations, int& deltaCost);	// unassigns the destroyed games
+	void Repair(int& deltaViolations, int& deltaCost);	// reassigns the destroyed games with the partial greedy
+	void MatchingRepair(int& deltaViolations, int& deltaCost);	// destroys a random date and reassigns it with the matching
+	void Restore();	// puts back the assignments of the destroyed games
+	void RecordAccepted();	// journals the changes of an accepted iteration
+	void SaveBest();	// the current solution becomes the best one
+	void RestoreBest();	// puts the best solution in the output object
+	void UndoSinceBest(RA_Output& o) const;	// undoes the journaled changes on the given solution
+	bool Accept(int deltaViolations, int deltaCost) const;
+	int Objective(int violations, int cost) const { return hardWeight * violations + cost; }
+
+	const RA_Input& in;
+	RA_Output& out;
+	RA_Output best;
+	MatchingRA matching;
+
+	// structures built once, to select the destroyed games without scanning the instance
+	vector<vector<int>> divisionGames;
+	vector<vector<int>> refereesByDistance;	// for each referee, all the referees sorted by distance from the referee's address
+	vector<bool> marked;	// games already in the destroyed set
+
+	vector<int> destroyed;
+	vector<set<int>> destroyedReferees;	// referees assigned to the destroyed games before the destruction
+	vector<pair<int, set<int>>> sinceBest;	// (game, referees before the change) of the accepted changes since the best solution
+	bool bestSaved;	// the journal became too long, and the best solution was copied in best
+
+	int currentViolations, currentCost;
+	int bestViolations, bestCost;
+	double temperature;
+	long unsigned iterations, accepted;
+
+	// parameters
+	long unsigned maxIterations = 10000;
+	double timeLimit = 0.0;
+	double startTemperature = 100.0;
+	double coolingRate = 0.999;
+	int maxDestroyed = 20;
+	int dateWindow = 1;
+	int closeReferees = 3;
+	double matchingRepairRate = 0.25;
+};
+
+#endif
@@ -1,13 +1,17 @@
 // File RA_Basics.cc
 #include "RA_Basics.hh"
+#include "RA_Profiler.hh"
 
 RA_State::RA_State(const RA_Input& i) 
   : RA_Output(i) {}
 
 RA_State& RA_State::operator=(const RA_State& st)
 {
+  RA_PROFILE_SCOPE("RA_State::operator=");
   games = st.games;
   referees = st.referees;
+  totalAssignments = st.totalAssignments;
+  refereeLoads = st.refereeLoads;
   return *this;
 }
   
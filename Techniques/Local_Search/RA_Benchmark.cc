@@ -0,0 +1,161 @@
+// File RA_Benchmark.cc
+#include "RA_Helpers.hh"
+#include "Random.hh"
+#include <chrono>
+#include <iomanip>
+#include <new>
+
+/*  Micro-benchmarks of the local search helpers: the delta cost components,
+    the cost components and RandomMove, FeasibleMove and MakeMove of both
+    neighborhoods, on the greedy state of each instance. Each operation is
+    repeated (doubling the repetitions) until it runs for at least the
+    minimum time, and it is reported in nanoseconds and heap allocations
+    per operation.
+*/
+
+// allocations counted by the replaced global operator new (single-threaded)
+static unsigned long allocations = 0;
+
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new and delete are replaced together
+
+void* operator new(size_t size)
+{
+  allocations++;
+  if (void* p = malloc(size ? size : 1))
+    return p;
+  throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+static double min_time = 0.2; // seconds
+static volatile long sink; // keeps the results alive
+
+// f(i) is the i-th operation
+template <typename Operation>
+void Measure(const string& name, Operation f)
+{
+  unsigned long n = 1, allocated;
+  double elapsed;
+
+  while (true)
+  {
+    unsigned long start_allocations = allocations;
+    auto start = chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; i++)
+      f(i);
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    allocated = allocations - start_allocations;
+    if (elapsed >= min_time)
+      break;
+    n *= 2;
+  }
+
+  cout << "  " << left << setw(52) << name << right << setw(12) << fixed << setprecision(1) << elapsed * 1e9 / n << " ns/op"
+       << setw(10) << setprecision(2) << static_cast<double>(allocated) / n << " allocs/op" << endl;
+}
+
+void Benchmark(const string& instance, unsigned seed, unsigned num_moves)
+{
+  RA_Input in = ReadInstance(instance);
+
+  RA_CostComponents components(in);
+  RA_StateManager RA_sm(in);
+  ChangeAssignedRefereesNeighborhoodExplorer RA_car_nhe(in, RA_sm);
+  AddRemoveRefereeNeighborhoodExplorer RA_arr_nhe(in, RA_sm);
+  const vector<CostComponent<RA_Input,RA_State>*>& cost_components = components.CostComponents();
+  const vector<DeltaCostComponent<RA_Input,RA_State,ChangeAssignedReferees>*>& car_delta_components = components.ChangeAssignedRefereesDeltaCostComponents();
+  const vector<DeltaCostComponent<RA_Input,RA_State,AddRemoveReferee>*>& arr_delta_components = components.AddRemoveRefereeDeltaCostComponents();
+
+  components.Attach(RA_sm, RA_car_nhe, RA_arr_nhe);
+
+  // the fixed state and moves: the greedy state, and random moves drawn from it
+  Random::SetSeed(seed);
+  SetRandomSeed(seed); // the ties of the greedy
+  RA_State st(in);
+  RA_sm.GreedyState(st);
+
+  vector<ChangeAssignedReferees> car_moves(num_moves);
+  vector<AddRemoveReferee> arr_moves(num_moves);
+  for (unsigned i = 0; i < num_moves; i++)
+  {
+    RA_car_nhe.RandomMove(st, car_moves[i]);
+    RA_arr_nhe.RandomMove(st, arr_moves[i]);
+  }
+
+  cout << instance << ": " << in.NumGames() << " games, " << in.NumReferees() << " referees, greedy state cost "
+       << RA_sm.CostFunctionComponents(st).total << endl;
+
+  for (CostComponent<RA_Input,RA_State>* cc : cost_components)
+    Measure(cc->name + "::ComputeCost", [&](unsigned long) { sink = cc->ComputeCost(st); });
+
+  for (DeltaCostComponent<RA_Input,RA_State,ChangeAssignedReferees>* dcc : car_delta_components)
+    Measure(dcc->name, [&](unsigned long i) { sink = dcc->DeltaCost(st, car_moves[i % num_moves]); });
+  for (DeltaCostComponent<RA_Input,RA_State,AddRemoveReferee>* dcc : arr_delta_components)
+    Measure(dcc->name, [&](unsigned long i) { sink = dcc->DeltaCost(st, arr_moves[i % num_moves]); });
+
+  ChangeAssignedReferees car_mv;
+  AddRemoveReferee arr_mv;
+  Measure("CAR RandomMove", [&](unsigned long) { RA_car_nhe.RandomMove(st, car_mv); sink = car_mv.game; });
+  Measure("ARR RandomMove", [&](unsigned long) { RA_arr_nhe.RandomMove(st, arr_mv); sink = arr_mv.game; });
+  Measure("CAR FeasibleMove", [&](unsigned long i) { sink = RA_car_nhe.FeasibleMove(st, car_moves[i % num_moves]); });
+  Measure("ARR FeasibleMove", [&](unsigned long i) { sink = RA_arr_nhe.FeasibleMove(st, arr_moves[i % num_moves]); });
+
+  // each move is made and undone by its inverse, so that the state (and the next moves) stay valid
+  RA_State work(in);
+  work = st;
+  vector<ChangeAssignedReferees> car_inverses(car_moves);
+  vector<AddRemoveReferee> arr_inverses(arr_moves);
+  for (unsigned i = 0; i < num_moves; i++)
+  {
+    swap(car_inverses[i].oldAssignedReferees, car_inverses[i].newAssignedReferees);
+    swap(arr_inverses[i].remReferee, arr_inverses[i].addReferee);
+  }
+  Measure("CAR MakeMove (move and inverse)", [&](unsigned long i) { RA_car_nhe.MakeMove(work, car_moves[i % num_moves]); RA_car_nhe.MakeMove(work, car_inverses[i % num_moves]); });
+  Measure("ARR MakeMove (move and inverse)", [&](unsigned long i) { RA_arr_nhe.MakeMove(work, arr_moves[i % num_moves]); RA_arr_nhe.MakeMove(work, arr_inverses[i % num_moves]); });
+  if (!(work == st))
+    cerr << "The moves and their inverses did not restore the state" << endl;
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned seed = 1, num_moves = 1000;
+  vector<string> instances;
+  bool usage = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+    if (arg == "-s" && i + 1 < argc)
+      seed = stoul(argv[++i]);
+    else if (arg == "-m" && i + 1 < argc)
+      num_moves = stoul(argv[++i]);
+    else if (arg == "-t" && i + 1 < argc)
+      min_time = stod(argv[++i]);
+    else if (arg[0] != '-')
+      instances.push_back(arg);
+    else
+      usage = true;
+  }
+  if (usage || num_moves == 0) // the moves are taken modulo their number
+  {
+    cerr << "Usage: " << argv[0] << " [-s seed] [-m moves (at least 1)] [-t min_seconds] instance_file..." << endl;
+    return 1;
+  }
+  if (instances.empty())
+    instances = { "../../RefAssign-Instances/Instances/RA-1-10.txt", "../../RefAssign-Instances/Instances/RA-3-30.txt",
+                  "../../RefAssign-Instances/Instances/RA-5-50.txt" };
+
+  for (const string& instance : instances)
+    Benchmark(instance, seed, num_moves);
+
+  return 0;
+}
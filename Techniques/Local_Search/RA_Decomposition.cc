@@ -0,0 +1,167 @@
+// File RA_Decomposition.cc
+#include "RA_Decomposition.hh"
+#include "RA_Matching.hh"
+#include "Random.hh"
+#include <thread>
+#include <atomic>
+
+/***************************************************************************
+ * Runner factory
+ ***************************************************************************/
+
+Runner<RA_Input,RA_State>* NewRunner(const string& method, const RA_Input& in, RA_StateManager& sm,
+                                     ChangeAssignedRefereesNeighborhoodExplorer& car_nhe,
+                                     AddRemoveRefereeNeighborhoodExplorer& arr_nhe, const string& name)
+{
+  if (method == "CAR_HC")
+    return new RA_TelemetryRunner<HillClimbing<RA_Input, RA_State, ChangeAssignedReferees>>(in, sm, car_nhe, name);
+  else if (method == "CAR_SD")
+    return new RA_TelemetryRunner<SteepestDescent<RA_Input, RA_State, ChangeAssignedReferees>>(in, sm, car_nhe, name);
+  else if (method == "CAR_TS")
+    return new RA_TelemetryRunner<TabuSearch<RA_Input, RA_State, ChangeAssignedReferees>>(in, sm, car_nhe, name,
+      [](const ChangeAssignedReferees& m1, const ChangeAssignedReferees& m2)->bool
+        { return m1.game == m2.game && m1.oldAssignedReferees == m2.newAssignedReferees && m1.newAssignedReferees == m2.oldAssignedReferees; });
+  else if (method == "CAR_SA")
+    return new RA_TelemetryRunner<SimulatedAnnealing<RA_Input, RA_State, ChangeAssignedReferees>>(in, sm, car_nhe, name);
+  else if (method == "CAR_SA_TB")
+    return new RA_TelemetryRunner<SimulatedAnnealingTimeBased<RA_Input, RA_State, ChangeAssignedReferees>>(in, sm, car_nhe, name);
+  else if (method == "ARR_HC")
+    return new RA_TelemetryRunner<HillClimbing<RA_Input, RA_State, AddRemoveReferee>>(in, sm, arr_nhe, name);
+  else if (method == "ARR_SD")
+    return new RA_TelemetryRunner<SteepestDescent<RA_Input, RA_State, AddRemoveReferee>>(in, sm, arr_nhe, name);
+  else if (method == "ARR_TS")
+    return new RA_TelemetryRunner<TabuSearch<RA_Input, RA_State, AddRemoveReferee>>(in, sm, arr_nhe, name,
+      [](const AddRemoveReferee& m1, const AddRemoveReferee& m2)->bool
+        { return m1.game == m2.game && m1.remReferee == m2.addReferee && m1.addReferee == m2.remReferee; });
+  else if (method == "ARR_SA")
+    return new RA_TelemetryRunner<SimulatedAnnealing<RA_Input, RA_State, AddRemoveReferee>>(in, sm, arr_nhe, name);
+  else if (method == "ARR_SA_TB")
+    return new RA_TelemetryRunner<SimulatedAnnealingTimeBased<RA_Input, RA_State, AddRemoveReferee>>(in, sm, arr_nhe, name);
+  else
+    throw invalid_argument("NewRunner: unrecognized method " + method);
+}
+
+/***************************************************************************
+ * Window Solver Methods
+ ***************************************************************************/
+
+RA_WindowSolver::RA_WindowSolver(const RA_Input& full_in, int fg, int lg, int index,
+                                 const string& method, Runner<RA_Input,RA_State>& prototype, const RA_StateManager& prototype_sm)
+  : in(full_in, fg, lg), first_game(fg), last_game(lg),
+    components(in), sm(in), car_nhe(in, sm), arr_nhe(in, sm), best(in)
+{
+  string name = "Window" + to_string(index) + "_" + method;
+
+  components.Attach(sm, car_nhe, arr_nhe);
+  sm.SetGreedy(prototype_sm.Greedy(), prototype_sm.RegretK());
+
+  runner.reset(NewRunner(method, in, sm, car_nhe, arr_nhe, name));
+
+  // the window runner gets the parameters of the runner of the whole instance
+  CommandLineParameters::Parametrized::RegisterParameters();
+  runner->CopyParameterValues(prototype);
+
+  // the evaluations allowed are shared among the windows in proportion to their games
+  if (prototype.MaxEvaluations() != numeric_limits<unsigned long int>::max())
+    runner->SetMaxEvaluations(prototype.MaxEvaluations() * in.NumGames() / full_in.NumGames() + 1);
+}
+
+// the window gets the same solution for the same seed, whatever the thread that solves it
+void RA_WindowSolver::Solve(bool random_initial_state, unsigned int seed)
+{
+  Random::SetThreadSeed(seed);
+  SetRandomSeed(seed); // the engine of the greedy
+
+  if (random_initial_state)
+    sm.RandomState(best);
+  else
+    sm.GreedyState(best);
+
+  runner->Go(best);
+}
+
+void RA_WindowSolver::CopySolution(RA_Output& out) const
+{
+  for (int g = 1; g <= in.NumGames(); g++)
+  {
+    out.UnassignAll(g + first_game - 1);
+    for (int r : best.AssignedReferees(g))
+      out.Assign(r, g + first_game - 1);
+  }
+}
+
+/***************************************************************************
+ * Decomposition Methods
+ ***************************************************************************/
+
+RA_Decomposition::RA_Decomposition(const RA_Input& i, int window_days, unsigned int t)
+  : in(i), threads(max(t, 1u))
+{
+  int d = 1;
+
+  while (d <= in.NumDates())
+  {
+    Date start = in.GetGame(in.FirstGameOfDate(d)).Match().StartDate();
+    Date end = start + window_days;
+    int first_game = in.FirstGameOfDate(d);
+
+    do
+      d++;
+    while (d <= in.NumDates() && in.GetGame(in.FirstGameOfDate(d)).Match().StartDate() < end);
+
+    windows.push_back(make_pair(first_game, in.FirstGameOfDate(d)));
+  }
+}
+
+void RA_Decomposition::Solve(RA_Output& out, const string& method, Runner<RA_Input,RA_State>& prototype, bool random_initial_state, const RA_StateManager& prototype_sm)
+{
+  double allowed_running_time;
+  unsigned int base_seed = Random::GetSeed();
+  atomic<unsigned int> next_window(0);
+  vector<thread> workers;
+
+  // the runners are built here, since the registration of the parameters is not thread-safe
+  solvers.clear();
+  for (unsigned int w = 0; w < windows.size(); w++)
+    solvers.emplace_back(new RA_WindowSolver(in, windows[w].first, windows[w].second, w + 1, method, prototype, prototype_sm));
+
+  // the time-based annealing splits its time among the windows run by the same thread
+  if (method == "CAR_SA_TB" || method == "ARR_SA_TB")
+  {
+    prototype.GetParameterValue("allowed_running_time", allowed_running_time);
+    allowed_running_time *= static_cast<double>(min<size_t>(threads, windows.size())) / windows.size();
+    for (auto& solver : solvers)
+      solver->SetAllowedRunningTime(allowed_running_time);
+  }
+
+  for (unsigned int t = 0; t < min<size_t>(threads, windows.size()); t++)
+    workers.emplace_back([&]()
+    {
+      unsigned int w;
+      while ((w = next_window++) < windows.size())
+        solvers[w]->Solve(random_initial_state, base_seed + w);
+    });
+
+  for (thread& worker : workers)
+    worker.join();
+
+  for (auto& solver : solvers)
+    solver->CopySolution(out);
+}
+
+int RA_Decomposition::RepairBoundaries(RA_Output& out) const
+{
+  MatchingRA matching(in);
+  int improvement = 0;
+
+  for (unsigned int w = 1; w < windows.size(); w++)
+  { // the last date of the previous window and the first date of the next one
+    int first_date = 1;
+    while (in.FirstGameOfDate(first_date) < windows[w].first)
+      first_date++;
+    improvement += matching.ImproveDate(out, first_date - 1);
+    improvement += matching.ImproveDate(out, first_date);
+  }
+
+  return improvement;
+}
@@ -0,0 +1,70 @@
+// File RA_Decomposition.hh
+#ifndef RA_DECOMPOSITION_HH
+#define RA_DECOMPOSITION_HH
+
+#include "RA_Helpers.hh"
+#include "RA_Telemetry.hh"
+#include <memory>
+
+/***************************************************************************
+ * Runner factory
+ ***************************************************************************/
+
+// a new runner of the given method (CAR_HC, ARR_SA, ...), to be deleted by the caller
+Runner<RA_Input,RA_State>* NewRunner(const string& method, const RA_Input& in, RA_StateManager& sm,
+                                     ChangeAssignedRefereesNeighborhoodExplorer& car_nhe,
+                                     AddRemoveRefereeNeighborhoodExplorer& arr_nhe, const string& name);
+
+/***************************************************************************
+ * Time-window decomposition
+ ***************************************************************************/
+
+/* The games (sorted by date in RA_Input) are split in windows of consecutive
+   days. Each window is a sub-instance solved on its own with a copy of the
+   selected runner, the windows being independent they are solved in parallel
+   (each one with its own seed, hence the result does not depend on the threads).
+   The window solutions are then merged, and the dates at the boundaries of the
+   windows (where the travels between adjacent days were ignored) are
+   reassigned with the matching. The global terms (GamesDistribution and
+   AssignmentFrequency) are left to a final local search on the full instance.
+*/
+class RA_WindowSolver
+{
+public:
+  RA_WindowSolver(const RA_Input& full_in, int first_game, int last_game, int index,
+                  const string& method, Runner<RA_Input,RA_State>& prototype, const RA_StateManager& prototype_sm);
+  void Solve(bool random_initial_state, unsigned int seed);
+  void CopySolution(RA_Output& out) const; // writes the window assignments in the full solution
+  void SetAllowedRunningTime(double t) { runner->SetParameter("allowed_running_time", t); }
+  int FirstGame() const { return first_game; }
+  int LastGame() const { return last_game; }
+protected:
+  const RA_Input in;
+  int first_game, last_game;
+
+  RA_CostComponents components;
+
+  RA_StateManager sm;
+  ChangeAssignedRefereesNeighborhoodExplorer car_nhe;
+  AddRemoveRefereeNeighborhoodExplorer arr_nhe;
+  unique_ptr<Runner<RA_Input,RA_State>> runner;
+  RA_State best;
+};
+
+class RA_Decomposition
+{
+public:
+  RA_Decomposition(const RA_Input& in, int window_days, unsigned int threads);
+  // solves the windows in parallel and merges them in out (previously reset), the greedy states built as by prototype_sm
+  void Solve(RA_Output& out, const string& method, Runner<RA_Input,RA_State>& prototype, bool random_initial_state, const RA_StateManager& prototype_sm);
+  // reassigns with the matching the first and the last date of each window, returns the improvement
+  int RepairBoundaries(RA_Output& out) const;
+  unsigned int NumWindows() const { return windows.size(); }
+protected:
+  const RA_Input& in;
+  unsigned int threads;
+  vector<pair<int,int>> windows; // [first game, last game) of each window
+  vector<unique_ptr<RA_WindowSolver>> solvers; // kept alive, the runners are referenced by the parameter lists
+};
+
+#endif
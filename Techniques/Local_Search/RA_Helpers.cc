@@ -1,6 +1,7 @@
 // File RA_Helpers.cc
 #include "RA_Helpers.hh"
 #include "RA_Greedy.hh"
+#include "Random.hh"
 #include <algorithm>
 #include <math.h>
 #include <iterator>
@@ -14,6 +15,7 @@
 
 int MinimumRefereesCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("MinimumRefereesCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -36,6 +38,7 @@ void MinimumRefereesCostComponent::PrintViolations(const RA_State& st, ostream&
 
 int MaximumRefereesCostComponent::ComputeCost(const RA_State& st) const
 { 
+  RA_PROFILE_SCOPE("MaximumRefereesCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -58,6 +61,7 @@ void MaximumRefereesCostComponent::PrintViolations(const RA_State& st, ostream&
 
 int FeasibleTravelDistanceCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("FeasibleTravelDistanceCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -80,6 +84,7 @@ void FeasibleTravelDistanceCostComponent::PrintViolations(const RA_State& st, os
 
 int RefereeAvailabilityCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("RefereeAvailabilityCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -102,6 +107,7 @@ void RefereeAvailabilityCostComponent::PrintViolations(const RA_State& st, ostre
 
 int MinimumLevelCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("MinimumLevelCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -124,6 +130,7 @@ void MinimumLevelCostComponent::PrintViolations(const RA_State& st, ostream& os)
 
 int LackOfExperienceCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("LackOfExperienceCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -146,6 +153,7 @@ void LackOfExperienceCostComponent::PrintViolations(const RA_State& st, ostream&
 
 int GamesDistributionCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("GamesDistributionCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -162,6 +170,7 @@ void GamesDistributionCostComponent::PrintViolations(const RA_State& st, ostream
 
 int TotalDistanceCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("TotalDistanceCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -178,6 +187,7 @@ void TotalDistanceCostComponent::PrintViolations(const RA_State& st, ostream& os
 
 int OptionalRefereeCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("OptionalRefereeCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -194,6 +204,7 @@ void OptionalRefereeCostComponent::PrintViolations(const RA_State& st, ostream&
 
 int AssignmentFrequencyCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("AssignmentFrequencyCostComponent::ComputeCost");
   int cost = 0;
 
   for (int r = 1; r <= in.NumReferees(); r++)
@@ -212,6 +223,7 @@ void AssignmentFrequencyCostComponent::PrintViolations(const RA_State& st, ostre
 
 int RefereeIncompatibilityCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("RefereeIncompatibilityCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -228,6 +240,7 @@ void RefereeIncompatibilityCostComponent::PrintViolations(const RA_State& st, os
 
 int TeamIncompatibilityCostComponent::ComputeCost(const RA_State& st) const
 {
+  RA_PROFILE_SCOPE("TeamIncompatibilityCostComponent::ComputeCost");
   int cost = 0;
 
   for (int g = 1; g <= in.NumGames(); g++)
@@ -244,7 +257,7 @@ void TeamIncompatibilityCostComponent::PrintViolations(const RA_State& st, ostre
 
 // constructor
 RA_StateManager::RA_StateManager(const RA_Input & pin) 
-  : StateManager<RA_Input,RA_State>(pin, "RAStateManager")  {} 
+  : StateManager<RA_Input,RA_State>(pin, "RAStateManager"), greedy("lazy"), regret_k(2) {} 
 
 // initial state builder (random referees assignment for each game)
 /* A random state is generated trying to guarantee that the minimum number of referees is
@@ -252,6 +265,7 @@ RA_StateManager::RA_StateManager(const RA_Input & pin)
 */
 void RA_StateManager::RandomState(RA_State& st) 
 {
+  RA_PROFILE_SCOPE("RA_StateManager::RandomState");
   set<int> referees, diffReferees;
   vector<int> games;
   int numAssignedReferees, refereePosition, optionalReferees;
@@ -264,7 +278,7 @@ void RA_StateManager::RandomState(RA_State& st)
   for (int g = 1; g <= in.NumGames(); g++)
     games.push_back(g);
 
-  random_shuffle(games.begin(), games.end());
+  shuffle(games.begin(), games.end(), Random::GetGenerator()); // the engine of the thread, if it has one
 
   st.Reset();
   for (int step = 0; step <= 1; step++)
@@ -312,12 +326,43 @@ void RA_StateManager::RandomState(RA_State& st)
 
 void RA_StateManager::GreedyState(RA_State& st)
 {
+  RA_PROFILE_SCOPE("RA_StateManager::GreedyState");
   if (RA_GREEDY)
-    GreedyRASolver(in, st);
+  {
+    SetRandomSeed(Random::GetGenerator()()); // the engine of the greedy follows the (thread) engine of the solver
+    if (greedy == "shuffle")
+      GreedyRASolver(in, st);
+    else if (greedy == "regret")
+      GreedyRARegretSolver(in, st, regret_k);
+    else
+      GreedyRALazySolver(in, st); // the criterion of GreedyRASolver, rescanning only the stale games
+  }
   else
     throw logic_error("RA_StateManager::GreedyState not included");
 }
 
+void RA_StateManager::GreedyState(RA_State& st, double alpha, unsigned int k)
+{
+  RA_PROFILE_SCOPE("RA_StateManager::GreedyState (randomized)");
+  if (RA_GREEDY)
+  {
+    SetRandomSeed(Random::GetGenerator()()); // the engine of the greedy follows the (thread) engine of the solver
+    GreedyRASolver(in, st, alpha, k);
+  }
+  else
+    throw logic_error("RA_StateManager::GreedyState not included");
+}
+
+void RA_StateManager::SetGreedy(const string& construction, int k)
+{
+  if (construction != "lazy" && construction != "shuffle" && construction != "regret")
+    throw invalid_argument("RA_StateManager::SetGreedy: unknown construction " + construction);
+  if (construction == "regret" && k < 2)
+    throw invalid_argument("RA_StateManager::SetGreedy: the regret greedy needs k >= 2");
+  greedy = construction;
+  regret_k = k;
+}
+
 bool RA_StateManager::CheckConsistency(const RA_State& st) const
 {
   int game, referee;
@@ -384,6 +429,7 @@ void RA_OutputManager::OutputState(const RA_State& st, RA_Output& out) const
 // initial move builder
 void ChangeAssignedRefereesNeighborhoodExplorer::RandomMove(const RA_State& st, ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::RandomMove");
   set<int> referees;
   int numAssignedReferees;
   int refereePosition;
@@ -408,12 +454,13 @@ void ChangeAssignedRefereesNeighborhoodExplorer::RandomMove(const RA_State& st,
       mv.newAssignedReferees.insert(*it);
       referees.erase(it);
     }
-  } while (!FeasibleMove(st, mv));
+  } while (!FeasibleMove(st, mv) && RA_PROFILE_REJECTION());
 } 
 
 // check move feasibility
 bool ChangeAssignedRefereesNeighborhoodExplorer::FeasibleMove(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::FeasibleMove");
 	if (mv.oldAssignedReferees == mv.newAssignedReferees)
 		return false;
 
@@ -441,6 +488,7 @@ bool ChangeAssignedRefereesNeighborhoodExplorer::FeasibleMove(const RA_State& st
 // update the state according to the move 
 void ChangeAssignedRefereesNeighborhoodExplorer::MakeMove(RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::MakeMove");
   st.UnassignAll(mv.game);
 
   for (set<int>::iterator it = mv.newAssignedReferees.begin(); it != mv.newAssignedReferees.end(); ++it)
@@ -449,6 +497,7 @@ void ChangeAssignedRefereesNeighborhoodExplorer::MakeMove(RA_State& st, const Ch
 
 void ChangeAssignedRefereesNeighborhoodExplorer::FirstMove(const RA_State& st, ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::FirstMove");
   // mv.game = Random::Uniform<int>(1, in.NumGames());
   mv.game = 1;
 
@@ -470,6 +519,7 @@ void ChangeAssignedRefereesNeighborhoodExplorer::FirstMove(const RA_State& st, C
 
 bool ChangeAssignedRefereesNeighborhoodExplorer::NextMove(const RA_State& st, ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::NextMove");
   do
     if (!AnyNextMove(st, mv))
       return false;
@@ -480,6 +530,7 @@ bool ChangeAssignedRefereesNeighborhoodExplorer::NextMove(const RA_State& st, Ch
 
 bool ChangeAssignedRefereesNeighborhoodExplorer::AnyNextMove(const RA_State& st, ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesNeighborhoodExplorer::AnyNextMove");
   const Division &division = in.GetDivision(in.GetGame(mv.game).Division());
   set<int>::reverse_iterator rit;
   vector<int> removeReferees;
@@ -547,61 +598,73 @@ bool ChangeAssignedRefereesNeighborhoodExplorer::AnyNextMove(const RA_State& st,
 
 int ChangeAssignedRefereesDeltaMinimumReferees::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaMinimumReferees::ComputeDeltaCost");
   return MinimumRefereesDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
           
 int ChangeAssignedRefereesDeltaMaximumReferees::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaMaximumReferees::ComputeDeltaCost");
   return MaximumRefereesDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaFeasibleTravelDistance::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaFeasibleTravelDistance::ComputeDeltaCost");
   return FeasibleTravelDistanceDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaRefereeAvailability::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaRefereeAvailability::ComputeDeltaCost");
   return RefereeAvailabilityDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaMinimumLevel::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaMinimumLevel::ComputeDeltaCost");
   return MinimumLevelDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaLackOfExperience::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaLackOfExperience::ComputeDeltaCost");
   return LackOfExperienceDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaGamesDistribution::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaGamesDistribution::ComputeDeltaCost");
   return GamesDistributionDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaTotalDistance::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaTotalDistance::ComputeDeltaCost");
   return TotalDistanceDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaOptionalReferee::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaOptionalReferee::ComputeDeltaCost");
   return OptionalRefereeDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaAssignmentFrequency::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaAssignmentFrequency::ComputeDeltaCost");
   return AssignmentFrequencyDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaRefereeIncompatibility::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaRefereeIncompatibility::ComputeDeltaCost");
   return RefereeIncompatibilityDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
 int ChangeAssignedRefereesDeltaTeamIncompatibility::ComputeDeltaCost(const RA_State& st, const ChangeAssignedReferees& mv) const
 {
+  RA_PROFILE_SCOPE("ChangeAssignedRefereesDeltaTeamIncompatibility::ComputeDeltaCost");
   return TeamIncompatibilityDeltaCost(in, st, mv.game, mv.oldAssignedReferees, mv.newAssignedReferees);
 }
 
@@ -612,6 +675,7 @@ int ChangeAssignedRefereesDeltaTeamIncompatibility::ComputeDeltaCost(const RA_St
 // initial move builder
 void AddRemoveRefereeNeighborhoodExplorer::RandomMove(const RA_State& st, AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::RandomMove");
   set<int> removableReferees;
   set<int>::iterator it;
   int refereePosition;
@@ -633,12 +697,13 @@ void AddRemoveRefereeNeighborhoodExplorer::RandomMove(const RA_State& st, AddRem
     while (st.AssignedReferees(mv.game).find(referee) != st.AssignedReferees(mv.game).end());
     
     mv.addReferee = referee;
-  } while (!FeasibleMove(st, mv));
+  } while (!FeasibleMove(st, mv) && RA_PROFILE_REJECTION());
 } 
 
 // check move feasibility
 bool AddRemoveRefereeNeighborhoodExplorer::FeasibleMove(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::FeasibleMove");
 	if (mv.remReferee == mv.addReferee) // i.e. mv.remReferee = mv.addReferee = 0
 		return false;
 
@@ -678,6 +743,7 @@ bool AddRemoveRefereeNeighborhoodExplorer::FeasibleMove(const RA_State& st, cons
 // update the state according to the move 
 void AddRemoveRefereeNeighborhoodExplorer::MakeMove(RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::MakeMove");
   if (mv.remReferee != 0)
     st.Unassign(mv.remReferee, mv.game);
 
@@ -687,6 +753,7 @@ void AddRemoveRefereeNeighborhoodExplorer::MakeMove(RA_State& st, const AddRemov
 
 void AddRemoveRefereeNeighborhoodExplorer::FirstMove(const RA_State& st, AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::FirstMove");
   // mv.game = Random::Uniform<int>(1, in.NumGames());
   mv.game = 1;
   mv.remReferee = 0;
@@ -696,6 +763,7 @@ void AddRemoveRefereeNeighborhoodExplorer::FirstMove(const RA_State& st, AddRemo
 
 bool AddRemoveRefereeNeighborhoodExplorer::NextMove(const RA_State& st, AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::NextMove");
   do
     if (!AnyNextMove(st, mv))
       return false;
@@ -706,6 +774,7 @@ bool AddRemoveRefereeNeighborhoodExplorer::NextMove(const RA_State& st, AddRemov
 
 bool AddRemoveRefereeNeighborhoodExplorer::AnyNextMove(const RA_State& st, AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveRefereeNeighborhoodExplorer::AnyNextMove");
   int numAssignedReferees = static_cast<int>(st.AssignedReferees(mv.game).size());
   int division = in.GetGame(mv.game).Division();
   int minReferees = in.GetDivision(division).MinReferees();
@@ -780,6 +849,7 @@ bool AddRemoveRefereeNeighborhoodExplorer::AnyNextMove(const RA_State& st, AddRe
 
 int AddRemoveDeltaMinimumReferees::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaMinimumReferees::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -794,6 +864,7 @@ int AddRemoveDeltaMinimumReferees::ComputeDeltaCost(const RA_State& st, const Ad
           
 int AddRemoveDeltaMaximumReferees::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaMaximumReferees::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -808,6 +879,7 @@ int AddRemoveDeltaMaximumReferees::ComputeDeltaCost(const RA_State& st, const Ad
 
 int AddRemoveDeltaFeasibleTravelDistance::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaFeasibleTravelDistance::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -822,6 +894,7 @@ int AddRemoveDeltaFeasibleTravelDistance::ComputeDeltaCost(const RA_State& st, c
 
 int AddRemoveDeltaRefereeAvailability::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaRefereeAvailability::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -836,6 +909,7 @@ int AddRemoveDeltaRefereeAvailability::ComputeDeltaCost(const RA_State& st, cons
 
 int AddRemoveDeltaMinimumLevel::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaMinimumLevel::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -850,6 +924,7 @@ int AddRemoveDeltaMinimumLevel::ComputeDeltaCost(const RA_State& st, const AddRe
 
 int AddRemoveDeltaLackOfExperience::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaLackOfExperience::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -864,6 +939,7 @@ int AddRemoveDeltaLackOfExperience::ComputeDeltaCost(const RA_State& st, const A
 
 int AddRemoveDeltaGamesDistribution::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaGamesDistribution::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -878,6 +954,7 @@ int AddRemoveDeltaGamesDistribution::ComputeDeltaCost(const RA_State& st, const
 
 int AddRemoveDeltaTotalDistance::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaTotalDistance::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -892,6 +969,7 @@ int AddRemoveDeltaTotalDistance::ComputeDeltaCost(const RA_State& st, const AddR
 
 int AddRemoveDeltaOptionalReferee::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaOptionalReferee::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -906,6 +984,7 @@ int AddRemoveDeltaOptionalReferee::ComputeDeltaCost(const RA_State& st, const Ad
 
 int AddRemoveDeltaAssignmentFrequency::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaAssignmentFrequency::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -920,6 +999,7 @@ int AddRemoveDeltaAssignmentFrequency::ComputeDeltaCost(const RA_State& st, cons
 
 int AddRemoveDeltaRefereeIncompatibility::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaRefereeIncompatibility::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -934,6 +1014,7 @@ int AddRemoveDeltaRefereeIncompatibility::ComputeDeltaCost(const RA_State& st, c
 
 int AddRemoveDeltaTeamIncompatibility::ComputeDeltaCost(const RA_State& st, const AddRemoveReferee& mv) const
 {
+  RA_PROFILE_SCOPE("AddRemoveDeltaTeamIncompatibility::ComputeDeltaCost");
   set<int> oldAssignedReferees(st.AssignedReferees(mv.game));
   set<int> newAssignedReferees(st.AssignedReferees(mv.game));
 
@@ -946,6 +1027,150 @@ int AddRemoveDeltaTeamIncompatibility::ComputeDeltaCost(const RA_State& st, cons
   return TeamIncompatibilityDeltaCost(in, st, mv.game, oldAssignedReferees, newAssignedReferees);
 }
 
+/*****************************************************************************
+ * AddRemoveReferee Kicker Methods
+ *****************************************************************************/
+
+AddRemoveRefereeKicker::AddRemoveRefereeKicker(const RA_Input & pin, StateManager<RA_Input,RA_State>& psm, AddRemoveRefereeNeighborhoodExplorer& pnhe)
+  : Kicker<RA_Input,RA_State,AddRemoveReferee>(psm, pnhe, related_moves), in(pin), arr_nhe(pnhe), gameDate(pin.NumGames() + 1)
+{
+  for (int d = 1; d <= in.NumDates(); d++)
+    for (int g = in.FirstGameOfDate(d); g < in.FirstGameOfDate(d + 1); g++)
+      gameDate[g] = d;
+
+  related_moves = [this](const AddRemoveReferee& mv1, const AddRemoveReferee& mv2)->bool
+  {
+    if (gameDate[mv1.game] == gameDate[mv2.game])
+      return true;
+    for (int r : {mv2.remReferee, mv2.addReferee})
+      if (r != 0 && (r == mv1.remReferee || r == mv1.addReferee))
+        return true;
+    return false;
+  };
+}
+
+pair<Kick<RA_State,AddRemoveReferee>,DefaultCostStructure<int>> AddRemoveRefereeKicker::SelectRandom(size_t length, const RA_State& st) const
+{
+  Kick<RA_State,AddRemoveReferee> kick;
+  DefaultCostStructure<int> cost(0, 0, 0, vector<int>(sm.CostComponents(), 0));
+  AddRemoveReferee mv;
+
+  kick.reserve(length);
+  for (size_t i = 0; i < length; i++)
+  {
+    const RA_State& current = i > 0 ? kick[i - 1].second : st;
+
+    if (i == 0)
+      arr_nhe.RandomMove(current, mv);
+    else if (!RandomRelatedMove(current, kick[i - 1].first.move, mv))
+      break; // the chain cannot be extended, the kick is shorter
+    kick.push_back(make_pair(EvaluatedMove<AddRemoveReferee,DefaultCostStructure<int>>(mv), current));
+    kick[i].first.cost = arr_nhe.DeltaCostFunctionComponents(current, mv);
+    kick[i].first.is_valid = true;
+    cost += kick[i].first.cost;
+    arr_nhe.MakeMove(kick[i].second, mv);
+  }
+
+  return make_pair(kick, cost);
+}
+
+bool AddRemoveRefereeKicker::RandomRelatedMove(const RA_State& st, const AddRemoveReferee& prev, AddRemoveReferee& mv) const
+{
+  int date = gameDate[prev.game], referee, game;
+  vector<int> referees;
+
+  if (prev.remReferee != 0)
+    referees.push_back(prev.remReferee);
+  if (prev.addReferee != 0)
+    referees.push_back(prev.addReferee);
+
+  for (unsigned int trial = 0; trial < max_trials; trial++)
+  {
+    if (!referees.empty() && Random::Uniform<int>(0, 1) == 0)
+    { // another game of a referee of the previous move, which is freed
+      referee = referees[Random::Uniform<int>(0, referees.size() - 1)];
+      const set<int>& games = st.AssignedGames(referee);
+      if (games.empty())
+        continue;
+      set<int>::const_iterator it = games.begin();
+      advance(it, Random::Uniform<int>(0, games.size() - 1));
+      game = *it;
+      if (RandomMoveOfGame(st, game, referee, mv))
+        return true;
+    }
+    else
+    { // a game of the same date
+      game = Random::Uniform<int>(in.FirstGameOfDate(date), in.FirstGameOfDate(date + 1) - 1);
+      if (RandomMoveOfGame(st, game, -1, mv))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+bool AddRemoveRefereeKicker::RandomMoveOfGame(const RA_State& st, int game, int remReferee, AddRemoveReferee& mv) const
+{
+  const set<int>& assignedReferees = st.AssignedReferees(game);
+  set<int>::const_iterator it;
+
+  mv.game = game;
+  if (remReferee >= 0)
+    mv.remReferee = remReferee;
+  else
+  { // 0 stands for no referee removed
+    int position = Random::Uniform<int>(0, assignedReferees.size());
+    if (position == 0)
+      mv.remReferee = 0;
+    else
+    {
+      it = assignedReferees.begin();
+      advance(it, position - 1);
+      mv.remReferee = *it;
+    }
+  }
+
+  do
+    mv.addReferee = Random::Uniform<int>(0, in.NumReferees());
+  while (mv.addReferee != 0 && assignedReferees.find(mv.addReferee) != assignedReferees.end());
+
+  return arr_nhe.FeasibleMove(st, mv);
+}
+
+/*****************************************************************************
+ * Cost Components Methods
+ *****************************************************************************/
+
+RA_CostComponents::RA_CostComponents(const RA_Input& in)
+  : cc1(in, 1, true), cc2(in, 1, true), cc3(in, 1, true), cc4(in, 1, true), cc5(in, 1, true),
+    cc6(in, in.LackOfExperienceWeight(), false), cc7(in, in.GamesDistributionWeight(), false),
+    cc8(in, in.TotalDistanceWeight(), false), cc9(in, in.OptionalRefereeWeight(), false),
+    cc10(in, in.AssignmentFrequencyWeight(), false), cc11(in, in.RefereeIncompatibilityWeight(), false),
+    cc12(in, in.TeamIncompatibilityWeight(), false),
+    car_dcc_1(in, cc1), car_dcc_2(in, cc2), car_dcc_3(in, cc3), car_dcc_4(in, cc4),
+    car_dcc_5(in, cc5), car_dcc_6(in, cc6), car_dcc_7(in, cc7), car_dcc_8(in, cc8),
+    car_dcc_9(in, cc9), car_dcc_10(in, cc10), car_dcc_11(in, cc11), car_dcc_12(in, cc12),
+    arr_dcc1(in, cc1), arr_dcc2(in, cc2), arr_dcc3(in, cc3), arr_dcc4(in, cc4),
+    arr_dcc5(in, cc5), arr_dcc6(in, cc6), arr_dcc7(in, cc7), arr_dcc8(in, cc8),
+    arr_dcc9(in, cc9), arr_dcc10(in, cc10), arr_dcc11(in, cc11), arr_dcc12(in, cc12),
+    cost_components({ &cc1, &cc2, &cc3, &cc4, &cc5, &cc6, &cc7, &cc8, &cc9, &cc10, &cc11, &cc12 }),
+    car_delta_cost_components({ &car_dcc_1, &car_dcc_2, &car_dcc_3, &car_dcc_4, &car_dcc_5, &car_dcc_6,
+                                &car_dcc_7, &car_dcc_8, &car_dcc_9, &car_dcc_10, &car_dcc_11, &car_dcc_12 }),
+    arr_delta_cost_components({ &arr_dcc1, &arr_dcc2, &arr_dcc3, &arr_dcc4, &arr_dcc5, &arr_dcc6,
+                                &arr_dcc7, &arr_dcc8, &arr_dcc9, &arr_dcc10, &arr_dcc11, &arr_dcc12 })
+{}
+
+// all cost components must be added to the state manager, and all delta cost components to the neighborhood explorers
+void RA_CostComponents::Attach(RA_StateManager& sm, ChangeAssignedRefereesNeighborhoodExplorer& car_nhe, AddRemoveRefereeNeighborhoodExplorer& arr_nhe) const
+{
+  for (CostComponent<RA_Input,RA_State>* cc : cost_components)
+    sm.AddCostComponent(*cc);
+  for (DeltaCostComponent<RA_Input,RA_State,ChangeAssignedReferees>* dcc : car_delta_cost_components)
+    car_nhe.AddDeltaCostComponent(*dcc);
+  for (DeltaCostComponent<RA_Input,RA_State,AddRemoveReferee>* dcc : arr_delta_cost_components)
+    arr_nhe.AddDeltaCostComponent(*dcc);
+}
+
 /***************************************************************************
  * Delta Cost Support Functions:
  ***************************************************************************/
@@ -1234,34 +1459,33 @@ int GamesDistributionDeltaCost(const RA_Input& in, const RA_State& st, int game,
   set<int>::iterator nend = newAssignedReferees.end();
   int numAssignedReferees = static_cast<int>(oldAssignedReferees.size());
   int numNewAssignedReferees = static_cast<int>(newAssignedReferees.size());
-  int oldTotalAssignedGames = 0, newTotalAssignedGames;
+  int oldTotalAssignedGames = st.TotalAssignments(), newTotalAssignedGames;
   double oldAverageAssignedGames, newAverageAssignedGames;
-  int oldGamesDistribution, newGamesDistribution;
+  const vector<int>& loads = st.RefereeLoads();
 
   set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
   set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
 
-  for (int r = 1; r <= in.NumReferees(); r++)
-    oldTotalAssignedGames += st.AssignedGames(r).size();
-
   newTotalAssignedGames = oldTotalAssignedGames + (numNewAssignedReferees - numAssignedReferees);
   oldAverageAssignedGames = static_cast<double>(oldTotalAssignedGames) / in.NumReferees();
   newAverageAssignedGames = static_cast<double>(newTotalAssignedGames) / in.NumReferees();
 
-  for (int r = 1; r <= in.NumReferees(); r++)
-  {
-    oldGamesDistribution = static_cast<int>(ceil(fabs(oldAverageAssignedGames - st.AssignedGames(r).size())));
+  // the shift of the average, for all the referees with the same number of games at once
+  if (newTotalAssignedGames != oldTotalAssignedGames)
+    for (unsigned n = 0; n < loads.size(); n++)
+      if (loads[n] > 0)
+        cost += loads[n] * (static_cast<int>(ceil(fabs(newAverageAssignedGames - n))) - static_cast<int>(ceil(fabs(oldAverageAssignedGames - n))));
 
-    if (oldDiffReferees.find(r) != oldDiffReferees.end() &&
-        newDiffReferees.find(r) == newDiffReferees.end())
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - (st.AssignedGames(r).size() - 1))));
-    else if (newDiffReferees.find(r) != newDiffReferees.end() &&
-             oldDiffReferees.find(r) == oldDiffReferees.end())
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - (st.AssignedGames(r).size() + 1))));
-    else
-      newGamesDistribution = static_cast<int>(ceil(fabs(newAverageAssignedGames - st.AssignedGames(r).size())));
-
-    cost += newGamesDistribution - oldGamesDistribution;
+  // the referees whose number of games changes
+  for (int r : oldDiffReferees)
+  {
+    int n = st.AssignedGames(r).size();
+    cost += static_cast<int>(ceil(fabs(newAverageAssignedGames - (n - 1)))) - static_cast<int>(ceil(fabs(newAverageAssignedGames - n)));
+  }
+  for (int r : newDiffReferees)
+  {
+    int n = st.AssignedGames(r).size();
+    cost += static_cast<int>(ceil(fabs(newAverageAssignedGames - (n + 1)))) - static_cast<int>(ceil(fabs(newAverageAssignedGames - n)));
   }
 
   return cost;
@@ -1504,91 +1728,17 @@ int AssignmentFrequencyDeltaCost(const RA_Input& in, const RA_State& st, int gam
 
 int RefereeIncompatibilityDeltaCost(const RA_Input& in, const RA_State& st, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees)
 {
-  int cost = 0;
-  set<int> oldDiffReferees, newDiffReferees;
-  set<int>::iterator itI, itJ, itF;
-  set<int>::iterator obeg = oldAssignedReferees.begin();
-  set<int>::iterator oend = oldAssignedReferees.end();
-  set<int>::iterator nbeg = newAssignedReferees.begin();
-  set<int>::iterator nend = newAssignedReferees.end();
-
-  set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
-  set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
+  const IncompatibilityMatrix &incompatibilities = in.RefereeIncompatibilities();
 
-  for (itI = oldDiffReferees.begin(); itI != oldDiffReferees.end(); ++itI)
-  {
-    for (itJ = obeg; itJ != oend; ++itJ)
-    {
-      const Referee &refereeI = in.GetReferee(*itI);
-      const Referee &refereeJ = in.GetReferee(*itJ);
-        
-      if (refereeI.IncompatibleReferee(refereeJ.Code()))
-        cost--;
-
-      itF = oldDiffReferees.find(refereeJ.Code());
-
-      if (itF == oldDiffReferees.end() && refereeJ.IncompatibleReferee(refereeI.Code()))
-        cost--;
-    }
-  }
-
-  for (itI = newDiffReferees.begin(); itI != newDiffReferees.end(); ++itI)
-  {
-    for (itJ = nbeg; itJ != nend; ++itJ)
-    {
-      const Referee &refereeI = in.GetReferee(*itI);
-      const Referee &refereeJ = in.GetReferee(*itJ);
-        
-      if (refereeI.IncompatibleReferee(refereeJ.Code()))
-        cost++;
-
-      itF = newDiffReferees.find(refereeJ.Code());
-
-      if (itF == newDiffReferees.end() && refereeJ.IncompatibleReferee(refereeI.Code()))
-        cost++;
-    }
-  }
-
-  return cost;
+  return incompatibilities.CountPairs(newAssignedReferees) - incompatibilities.CountPairs(oldAssignedReferees);
 }
 
 int TeamIncompatibilityDeltaCost(const RA_Input& in, const RA_State& st, int game, const set<int>& oldAssignedReferees, const set<int>& newAssignedReferees)
 {
-  int cost = 0;
-  set<int> oldDiffReferees, newDiffReferees;
-  set<int>::iterator it;
-  set<int>::iterator obeg = oldAssignedReferees.begin();
-  set<int>::iterator oend = oldAssignedReferees.end();
-  set<int>::iterator nbeg = newAssignedReferees.begin();
-  set<int>::iterator nend = newAssignedReferees.end();
-  const Team &homeTeam = in.GetTeam(in.GetGame(game).HomeTeam());
-  const Team &awayTeam = in.GetTeam(in.GetGame(game).AwayTeam());
-
-  set_difference(obeg, oend, nbeg, nend, inserter(oldDiffReferees, oldDiffReferees.end()));
-  set_difference(nbeg, nend, obeg, oend, inserter(newDiffReferees, newDiffReferees.end()));
-
-  for (it = oldDiffReferees.begin(); it != oldDiffReferees.end(); ++it)
-  {
-    const Referee &referee = in.GetReferee(*it);
-
-    if (referee.IncompatibleTeam(homeTeam.Code()))
-      cost--;
-
-    if (referee.IncompatibleTeam(awayTeam.Code()))
-      cost--;
-  }
-
-  for (it = newDiffReferees.begin(); it != newDiffReferees.end(); ++it)
-  {
-    const Referee &referee = in.GetReferee(*it);
-
-    if (referee.IncompatibleTeam(homeTeam.Code()))
-      cost++;
+  const IncompatibilityMatrix &incompatibilities = in.TeamIncompatibilities();
+  const Game &g = in.GetGame(game);
 
-    if (referee.IncompatibleTeam(awayTeam.Code()))
-      cost++;
-  }
-
-  return cost;
+  return incompatibilities.Count(g.HomeTeam(), newAssignedReferees) + incompatibilities.Count(g.AwayTeam(), newAssignedReferees)
+    - incompatibilities.Count(g.HomeTeam(), oldAssignedReferees) - incompatibilities.Count(g.AwayTeam(), oldAssignedReferees);
 }
 
@@ -3,6 +3,7 @@
 #define RA_HELPERS_HH
 
 #include "RA_Basics.hh"
+#include "RA_Profiler.hh"
 #include <easylocal.hh>
 
 using namespace EasyLocal::Core;
@@ -124,8 +125,16 @@ class RA_StateManager : public StateManager<RA_Input,RA_State>
 public:
   RA_StateManager(const RA_Input &);
   void RandomState(RA_State&);   
-  void GreedyState(RA_State&);
+  void GreedyState(RA_State&); // with the construction set by SetGreedy
+  void GreedyState(RA_State&, double alpha, unsigned int k); // randomized greedy, k bounds the restricted candidate list (0: no bound)
   bool CheckConsistency(const RA_State& st) const;
+  // the construction of GreedyState: lazy (default), shuffle or regret (regret-k, k >= 2)
+  void SetGreedy(const string& construction, int regret_k = 2);
+  const string& Greedy() const { return greedy; }
+  int RegretK() const { return regret_k; }
+protected:
+  string greedy;
+  int regret_k;
 }; 
 
 /***************************************************************************
@@ -404,6 +413,33 @@ public:
   bool AnyNextMove(const RA_State&, AddRemoveReferee&) const;
 };
 
+/***************************************************************************
+ * AddRemoveReferee Kicker:
+ ***************************************************************************/
+
+/* Kicks are chains of AddRemoveReferee moves over related games: two moves
+   are related if their games are on the same date or if they share a
+   referee. The random kick follows the chain directly (a game of the same
+   date, or a game assigned to a referee of the previous move, which is
+   removed from it), instead of scanning the neighborhood for a related move.
+*/
+class AddRemoveRefereeKicker
+  : public Kicker<RA_Input,RA_State,AddRemoveReferee>
+{
+public:
+  AddRemoveRefereeKicker(const RA_Input & pin, StateManager<RA_Input,RA_State>& psm, AddRemoveRefereeNeighborhoodExplorer& pnhe);
+  pair<Kick<RA_State,AddRemoveReferee>,DefaultCostStructure<int>> SelectRandom(size_t length, const RA_State& st) const;
+protected:
+  bool RandomRelatedMove(const RA_State& st, const AddRemoveReferee& prev, AddRemoveReferee& mv) const;
+  bool RandomMoveOfGame(const RA_State& st, int game, int remReferee, AddRemoveReferee& mv) const; // remReferee = -1 for any
+  const RA_Input& in;
+  AddRemoveRefereeNeighborhoodExplorer& arr_nhe;
+  vector<int> gameDate; // date index of each game
+  // bound by reference in the base class, it is constructed before its first use
+  MoveRelatedness related_moves;
+  const unsigned int max_trials = 100;
+};
+
 /***************************************************************************
  * Output Manager:
  ***************************************************************************/
@@ -417,6 +453,70 @@ public:
   void OutputState(const RA_State&, RA_Output&) const; 
 }; 
 
+/***************************************************************************
+ * Cost Components:
+ ***************************************************************************/
+
+/* The cost components (the hard ones with weight 1, the soft ones with the
+   weights of the input) and their delta cost components for the two
+   neighborhoods, added in the same order to a state manager and to the
+   neighborhood explorers by Attach. The helpers keep references to them,
+   hence they must live as long as the helpers.
+*/
+class RA_CostComponents
+{
+public:
+  RA_CostComponents(const RA_Input& in);
+  RA_CostComponents(const RA_CostComponents&) = delete;
+  void Attach(RA_StateManager& sm, ChangeAssignedRefereesNeighborhoodExplorer& car_nhe, AddRemoveRefereeNeighborhoodExplorer& arr_nhe) const;
+  const vector<CostComponent<RA_Input,RA_State>*>& CostComponents() const { return cost_components; }
+  const vector<DeltaCostComponent<RA_Input,RA_State,ChangeAssignedReferees>*>& ChangeAssignedRefereesDeltaCostComponents() const { return car_delta_cost_components; }
+  const vector<DeltaCostComponent<RA_Input,RA_State,AddRemoveReferee>*>& AddRemoveRefereeDeltaCostComponents() const { return arr_delta_cost_components; }
+protected:
+  MinimumRefereesCostComponent cc1;
+  MaximumRefereesCostComponent cc2;
+  FeasibleTravelDistanceCostComponent cc3;
+  RefereeAvailabilityCostComponent cc4;
+  MinimumLevelCostComponent cc5;
+  LackOfExperienceCostComponent cc6;
+  GamesDistributionCostComponent cc7;
+  TotalDistanceCostComponent cc8;
+  OptionalRefereeCostComponent cc9;
+  AssignmentFrequencyCostComponent cc10;
+  RefereeIncompatibilityCostComponent cc11;
+  TeamIncompatibilityCostComponent cc12;
+
+  ChangeAssignedRefereesDeltaMinimumReferees car_dcc_1;
+  ChangeAssignedRefereesDeltaMaximumReferees car_dcc_2;
+  ChangeAssignedRefereesDeltaFeasibleTravelDistance car_dcc_3;
+  ChangeAssignedRefereesDeltaRefereeAvailability car_dcc_4;
+  ChangeAssignedRefereesDeltaMinimumLevel car_dcc_5;
+  ChangeAssignedRefereesDeltaLackOfExperience car_dcc_6;
+  ChangeAssignedRefereesDeltaGamesDistribution car_dcc_7;
+  ChangeAssignedRefereesDeltaTotalDistance car_dcc_8;
+  ChangeAssignedRefereesDeltaOptionalReferee car_dcc_9;
+  ChangeAssignedRefereesDeltaAssignmentFrequency car_dcc_10;
+  ChangeAssignedRefereesDeltaRefereeIncompatibility car_dcc_11;
+  ChangeAssignedRefereesDeltaTeamIncompatibility car_dcc_12;
+
+  AddRemoveDeltaMinimumReferees arr_dcc1;
+  AddRemoveDeltaMaximumReferees arr_dcc2;
+  AddRemoveDeltaFeasibleTravelDistance arr_dcc3;
+  AddRemoveDeltaRefereeAvailability arr_dcc4;
+  AddRemoveDeltaMinimumLevel arr_dcc5;
+  AddRemoveDeltaLackOfExperience arr_dcc6;
+  AddRemoveDeltaGamesDistribution arr_dcc7;
+  AddRemoveDeltaTotalDistance arr_dcc8;
+  AddRemoveDeltaOptionalReferee arr_dcc9;
+  AddRemoveDeltaAssignmentFrequency arr_dcc10;
+  AddRemoveDeltaRefereeIncompatibility arr_dcc11;
+  AddRemoveDeltaTeamIncompatibility arr_dcc12;
+
+  vector<CostComponent<RA_Input,RA_State>*> cost_components;
+  vector<DeltaCostComponent<RA_Input,RA_State,ChangeAssignedReferees>*> car_delta_cost_components;
+  vector<DeltaCostComponent<RA_Input,RA_State,AddRemoveReferee>*> arr_delta_cost_components;
+};
+
 /***************************************************************************
  * Delta Cost Support Functions:
  ***************************************************************************/
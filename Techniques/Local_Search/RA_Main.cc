@@ -1,7 +1,72 @@
 #include "RA_Helpers.hh"
+#include "RA_Matching.hh"
+#include "RA_Decomposition.hh"
+#include "RA_Parser.hh"
 
 using namespace EasyLocal::Debug;
 
+// minimum, quartiles, maximum and mean of the (total) costs
+void PrintCostDistribution(ostream& os, const string& name, vector<DefaultCostStructure<int>> costs)
+{
+  double mean = 0.0;
+
+  if (costs.empty())
+    return;
+
+  sort(costs.begin(), costs.end());
+  for (const DefaultCostStructure<int>& c : costs)
+    mean += c.total;
+  mean /= costs.size();
+
+  os << name << ": min " << costs.front().total << ", q1 " << costs[costs.size() / 4].total
+     << ", median " << costs[costs.size() / 2].total << ", q3 " << costs[3 * costs.size() / 4].total
+     << ", max " << costs.back().total << ", mean " << mean << endl;
+}
+
+// the solution and its cost components as JSON (format "json") or as a header and a line of costs (format "csv")
+void PrintStructuredResult(ostream& os, const string& format, const string& instance, const string& method, const RA_Input& in,
+                           const RA_StateManager& sm, const RA_Output& out, const DefaultCostStructure<int>& cost, double running_time)
+{
+  if (format == "json")
+  {
+    nlohmann::json result, components = nlohmann::json::array(), assignments = nlohmann::json::array();
+
+    for (size_t i = 0; i < sm.CostComponents(); i++)
+      components.push_back({ {"name", sm.GetCostComponent(i).name}, {"hard", sm.GetCostComponent(i).IsHard()},
+                             {"weight", sm.GetCostComponent(i).Weight()}, {"cost", cost.all_components[i]} });
+    for (int g = 1; g <= in.NumGames(); g++)
+    {
+      nlohmann::json referees = nlohmann::json::array();
+      for (int r : out.AssignedReferees(g))
+        referees.push_back("R" + to_string(in.GetReferee(r).Code()));
+      assignments.push_back({ {"home", "T" + to_string(in.GetTeam(in.GetGame(g).HomeTeam()).Code())},
+                              {"away", "T" + to_string(in.GetTeam(in.GetGame(g).AwayTeam()).Code())}, {"referees", referees} });
+    }
+    result["instance"] = instance;
+    result["method"] = method;
+    result["cost"] = cost.total;
+    result["violations"] = cost.violations;
+    result["objective"] = cost.objective;
+    result["time"] = running_time;
+    result["components"] = components;
+    result["assignments"] = assignments;
+    os << result.dump(2) << '\n';
+  }
+  else
+  {
+    string header = "instance,method,cost,violations,objective,time";
+    ostringstream values;
+
+    values << instance << ',' << method << ',' << cost.total << ',' << cost.violations << ',' << cost.objective << ',' << running_time;
+    for (size_t i = 0; i < sm.CostComponents(); i++)
+    {
+      header += ',' + sm.GetCostComponent(i).name;
+      values << ',' << cost.all_components[i];
+    }
+    os << header << '\n' << values.str() << '\n';
+  }
+}
+
 int main(int argc, const char* argv[])
 {
   ParameterBox main_parameters("main", "Main Program options");
@@ -12,6 +77,15 @@ int main(int argc, const char* argv[])
   Parameter<string> method("method", "Solution method (empty for tester)", main_parameters);   
   Parameter<string> init_state("init_state", "Initial state (to be read from file)", main_parameters);
   Parameter<string> output_file("output_file", "Write the output to a file (filename required)", main_parameters);
+  Parameter<string> output_format("output_format", "Format of the output: text (default), json (solution and cost components) or csv (cost components)", main_parameters);
+  Parameter<bool> polish("polish", "Polish the final solution reassigning each date with the matching", main_parameters);
+  Parameter<string> greedy("greedy", "Construction of the greedy initial state (with random_state disabled): lazy (default), shuffle or regret", main_parameters);
+  Parameter<int> regret_k("regret_k", "k of the regret greedy, at least 2 (default 2)", main_parameters);
+  Parameter<int> window_days("window_days", "Decompose the instance in windows of days solved separately (window length)", main_parameters);
+  Parameter<unsigned long> final_idle_iterations("final_idle_iterations", "Idle iterations of the hill climbing after the decomposition (default 10000)", main_parameters);
+  Parameter<string> telemetry_file("telemetry_file", "Write the search trajectory of the runners as JSON lines (filename required)", main_parameters);
+  Parameter<unsigned long> telemetry_interval("telemetry_interval", "Iterations between two telemetry records (default 1000)", main_parameters);
+  Parameter<int> threads("threads", "Number of threads solving the windows of the decomposition, or running the GRASP trials", main_parameters);
   Parameter<int> loe("loe", "LackOfExperience weight", main_parameters);
   Parameter<int> gd("gd", "GamesDistribution weight", main_parameters);
   Parameter<int> td("td", "TotalDistance weight", main_parameters);
@@ -30,8 +104,32 @@ int main(int argc, const char* argv[])
     return 1;
   }
 
+  if (output_format.IsSet() && string(output_format) != "text" && string(output_format) != "json" && string(output_format) != "csv")
+  {
+    cout << "Error: --main::output_format must be text, json or csv" << endl;
+    return 1;
+  }
+
+  if (threads.IsSet() && threads < 1)
+  { // for the decomposition and for GRASP
+    cout << "Error: --main::threads must be at least 1" << endl;
+    return 1;
+  }
+
+  if (greedy.IsSet() && string(greedy) != "lazy" && string(greedy) != "shuffle" && string(greedy) != "regret")
+  {
+    cout << "Error: --main::greedy must be lazy, shuffle or regret" << endl;
+    return 1;
+  }
+
+  if (regret_k.IsSet() && regret_k < 2)
+  {
+    cout << "Error: --main::regret_k must be at least 2" << endl;
+    return 1;
+  }
+
   // Input object
-  RA_Input in(instance);
+  RA_Input in = ReadInstance(instance);
 
   if (seed.IsSet())
     Random::SetSeed(seed);
@@ -58,45 +156,8 @@ int main(int argc, const char* argv[])
   if (ti.IsSet())
     in.SetTeamIncompatibilityWeight(ti);
   
-  // cost components: second parameter is the cost, third is the type (true -> hard, false -> soft)
-  MinimumRefereesCostComponent cc1(in, 1, true);
-  MaximumRefereesCostComponent cc2(in, 1, true);
-  FeasibleTravelDistanceCostComponent cc3(in, 1, true);
-  RefereeAvailabilityCostComponent cc4(in, 1, true);
-  MinimumLevelCostComponent cc5(in, 1, true);
-  LackOfExperienceCostComponent cc6(in, in.LackOfExperienceWeight(), false);
-  GamesDistributionCostComponent cc7(in, in.GamesDistributionWeight(), false);
-  TotalDistanceCostComponent cc8(in, in.TotalDistanceWeight(), false);
-  OptionalRefereeCostComponent cc9(in, in.OptionalRefereeWeight(), false);
-  AssignmentFrequencyCostComponent cc10(in, in.AssignmentFrequencyWeight(), false);
-  RefereeIncompatibilityCostComponent cc11(in, in.RefereeIncompatibilityWeight(), false);
-  TeamIncompatibilityCostComponent cc12(in, in.TeamIncompatibilityWeight(), false);
- 
-  ChangeAssignedRefereesDeltaMinimumReferees car_dcc_1(in, cc1);
-  ChangeAssignedRefereesDeltaMaximumReferees car_dcc_2(in, cc2);
-  ChangeAssignedRefereesDeltaFeasibleTravelDistance car_dcc_3(in, cc3);
-  ChangeAssignedRefereesDeltaRefereeAvailability car_dcc_4(in, cc4);
-  ChangeAssignedRefereesDeltaMinimumLevel car_dcc_5(in, cc5);
-  ChangeAssignedRefereesDeltaLackOfExperience car_dcc_6(in, cc6);
-  ChangeAssignedRefereesDeltaGamesDistribution car_dcc_7(in, cc7);
-  ChangeAssignedRefereesDeltaTotalDistance car_dcc_8(in, cc8);
-  ChangeAssignedRefereesDeltaOptionalReferee car_dcc_9(in, cc9);
-  ChangeAssignedRefereesDeltaAssignmentFrequency car_dcc_10(in, cc10);
-  ChangeAssignedRefereesDeltaRefereeIncompatibility car_dcc_11(in, cc11);
-  ChangeAssignedRefereesDeltaTeamIncompatibility car_dcc_12(in, cc12);
-
-  AddRemoveDeltaMinimumReferees arr_dcc1(in, cc1);
-  AddRemoveDeltaMaximumReferees arr_dcc2(in, cc2);
-  AddRemoveDeltaFeasibleTravelDistance arr_dcc3(in, cc3);
-  AddRemoveDeltaRefereeAvailability arr_dcc4(in, cc4);
-  AddRemoveDeltaMinimumLevel arr_dcc5(in, cc5);
-  AddRemoveDeltaLackOfExperience arr_dcc6(in, cc6);
-  AddRemoveDeltaGamesDistribution arr_dcc7(in, cc7);
-  AddRemoveDeltaTotalDistance arr_dcc8(in, cc8);
-  AddRemoveDeltaOptionalReferee arr_dcc9(in, cc9);
-  AddRemoveDeltaAssignmentFrequency arr_dcc10(in, cc10);
-  AddRemoveDeltaRefereeIncompatibility arr_dcc11(in, cc11);
-  AddRemoveDeltaTeamIncompatibility arr_dcc12(in, cc12);
+  // cost components (hard with weight 1, soft with the weights above) and their delta cost components
+  RA_CostComponents RA_cc(in);
 
   // helpers
   RA_StateManager RA_sm(in);
@@ -104,124 +165,222 @@ int main(int argc, const char* argv[])
   AddRemoveRefereeNeighborhoodExplorer RA_arr_nhe(in, RA_sm);
 
   RA_OutputManager RA_om(in);
+
+  if (greedy.IsSet())
+    RA_sm.SetGreedy(greedy, regret_k.IsSet() ? static_cast<int>(regret_k) : 2);
   
-  // All cost components must be added to the state manager
-  RA_sm.AddCostComponent(cc1);
-  RA_sm.AddCostComponent(cc2);
-  RA_sm.AddCostComponent(cc3);
-  RA_sm.AddCostComponent(cc4);
-  RA_sm.AddCostComponent(cc5);
-  RA_sm.AddCostComponent(cc6);
-  RA_sm.AddCostComponent(cc7);
-  RA_sm.AddCostComponent(cc8);
-  RA_sm.AddCostComponent(cc9);
-  RA_sm.AddCostComponent(cc10);
-  RA_sm.AddCostComponent(cc11);
-  RA_sm.AddCostComponent(cc12);
-  
-  // All delta cost components must be added to the neighborhood explorer
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_1);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_2);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_3);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_4);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_5);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_6);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_7);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_8);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_9);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_10);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_11);
-  RA_car_nhe.AddDeltaCostComponent(car_dcc_12);
-
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc1);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc2);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc3);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc4);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc5);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc6);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc7);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc8);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc9);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc10);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc11);
-  RA_arr_nhe.AddDeltaCostComponent(arr_dcc12);
+  // All cost components must be added to the state manager, and the delta ones to the neighborhood explorers
+  RA_cc.Attach(RA_sm, RA_car_nhe, RA_arr_nhe);
   
-  // runners
-  HillClimbing<RA_Input, RA_State, ChangeAssignedReferees> RA_car_hc(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_HillClimbing");
-  SteepestDescent<RA_Input, RA_State, ChangeAssignedReferees> RA_car_sd(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_SteepestDescent");
-  TabuSearch<RA_Input, RA_State, ChangeAssignedReferees> RA_car_ts(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_TabuSearch",
+  // runners (with the trajectory telemetry, active only with --main::telemetry_file)
+  RA_TelemetryRunner<HillClimbing<RA_Input, RA_State, ChangeAssignedReferees>> RA_car_hc(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_HillClimbing");
+  RA_TelemetryRunner<SteepestDescent<RA_Input, RA_State, ChangeAssignedReferees>> RA_car_sd(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_SteepestDescent");
+  RA_TelemetryRunner<TabuSearch<RA_Input, RA_State, ChangeAssignedReferees>> RA_car_ts(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_TabuSearch",
     [](const ChangeAssignedReferees& m1, const ChangeAssignedReferees& m2)->bool
       { return m1.game == m2.game && m1.oldAssignedReferees == m2.newAssignedReferees && m1.newAssignedReferees == m2.oldAssignedReferees; });
-  SimulatedAnnealing<RA_Input, RA_State, ChangeAssignedReferees> RA_car_sa(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_SimulatedAnnealing");
+  RA_TelemetryRunner<SimulatedAnnealing<RA_Input, RA_State, ChangeAssignedReferees>> RA_car_sa(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_SimulatedAnnealing");
+  RA_TelemetryRunner<SimulatedAnnealingTimeBased<RA_Input, RA_State, ChangeAssignedReferees>> RA_car_sa_tb(in, RA_sm, RA_car_nhe, "ChangeAssignedReferees_SimulatedAnnealingTimeBased");
 
-  HillClimbing<RA_Input, RA_State, AddRemoveReferee> RA_arr_hc(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_HillClimbing");
-  SteepestDescent<RA_Input, RA_State, AddRemoveReferee> RA_arr_sd(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_SteepestDescent");
-  TabuSearch<RA_Input, RA_State, AddRemoveReferee> RA_arr_ts(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_TabuSearch",
+  RA_TelemetryRunner<HillClimbing<RA_Input, RA_State, AddRemoveReferee>> RA_arr_hc(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_HillClimbing");
+  RA_TelemetryRunner<SteepestDescent<RA_Input, RA_State, AddRemoveReferee>> RA_arr_sd(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_SteepestDescent");
+  RA_TelemetryRunner<TabuSearch<RA_Input, RA_State, AddRemoveReferee>> RA_arr_ts(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_TabuSearch",
     [](const AddRemoveReferee& m1, const AddRemoveReferee& m2)->bool
       { return m1.game == m2.game && m1.remReferee == m2.addReferee && m1.addReferee == m2.remReferee; });
-  SimulatedAnnealing<RA_Input, RA_State, AddRemoveReferee> RA_arr_sa(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_SimulatedAnnealing");
+  RA_TelemetryRunner<SimulatedAnnealing<RA_Input, RA_State, AddRemoveReferee>> RA_arr_sa(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_SimulatedAnnealing");
+  RA_TelemetryRunner<SimulatedAnnealingTimeBased<RA_Input, RA_State, AddRemoveReferee>> RA_arr_sa_tb(in, RA_sm, RA_arr_nhe, "AddRemoveReferee_SimulatedAnnealingTimeBased");
+
+  // kicker: chains of AddRemoveReferee moves over games of the same date or sharing a referee
+  AddRemoveRefereeKicker RA_arr_kicker(in, RA_sm, RA_arr_nhe);
 
   // tester
   Tester<RA_Input, RA_Output, RA_State> tester(in,RA_sm,RA_om);
   MoveTester<RA_Input, RA_Output, RA_State, ChangeAssignedReferees> car_swap_move_test(in,RA_sm,RA_om,RA_car_nhe, "ChangeAssignedReferees move", tester); 
   MoveTester<RA_Input, RA_Output, RA_State, AddRemoveReferee> arr_swap_move_test(in,RA_sm,RA_om,RA_arr_nhe, "AddRemoveReferee move", tester);
+  KickerTester<RA_Input, RA_Output, RA_State, AddRemoveReferee> arr_kick_test(in,RA_sm,RA_om,RA_arr_kicker, "AddRemoveReferee kicker", tester);
 
   // solver
   SimpleLocalSearch<RA_Input, RA_Output, RA_State> RA_solver(in, RA_sm, RA_om, "RA solver");
+  IteratedLocalSearch<RA_Input, RA_Output, RA_State, AddRemoveReferee> RA_ils(in, RA_sm, RA_om, "RA ILS");
+  GRASP<RA_Input, RA_Output, RA_State> RA_grasp(in, RA_sm, RA_om, "RA GRASP");
 
   if (!CommandLineParameters::Parse(argc, argv, true, false))
     return 1;
 
   if (!method.IsSet())
   { // If no search method is set -> enter in the tester
-    if (init_state.IsSet())
-      tester.RunMainMenu(init_state);
-    else
-      tester.RunMainMenu();
+    try
+    {
+      if (init_state.IsSet())
+        tester.RunMainMenu(init_state);
+      else
+        tester.RunMainMenu();
+    }
+    catch (const RA_ParseError& e)
+    { // a malformed state file, read by the tester
+      cerr << "Cannot read the state" << (init_state.IsSet() ? " " + string(init_state) : string()) << ": " << e.what() << endl;
+      return 1;
+    }
   }
   else
   {
-    if (method == string("CAR_SA"))
-      RA_solver.SetRunner(RA_car_sa);
-    else if (method == string("CAR_TS"))
-      RA_solver.SetRunner(RA_car_ts);
-    else if (method == string("CAR_HC"))
-      RA_solver.SetRunner(RA_car_hc);
-    else if (method == string("CAR_SD"))
-      RA_solver.SetRunner(RA_car_sd);
-    else if (method == string("ARR_SA"))
-      RA_solver.SetRunner(RA_arr_sa);
-    else if (method == string("ARR_TS"))
-      RA_solver.SetRunner(RA_arr_ts);
-    else if (method == string("ARR_HC"))
-      RA_solver.SetRunner(RA_arr_hc);
-    else if (method == string("ARR_SD"))
-      RA_solver.SetRunner(RA_arr_sd);
+    Runner<RA_Input, RA_State>* runner;
+    vector<unique_ptr<Runner<RA_Input, RA_State>>> grasp_runners;
+    // the runner of the method, without the suffix (the output reports the whole method)
+    string runner_method = method;
+    // a method with the _ILS suffix alternates its runner with the kicks of the iterated local search
+    bool iterated = string(method).size() > 4 && string(method).substr(string(method).size() - 4) == "_ILS";
+    // a method with the _GRASP suffix runs its runner after each randomized greedy construction
+    bool grasp = string(method).size() > 6 && string(method).substr(string(method).size() - 6) == "_GRASP";
+
+    if (iterated)
+      runner_method = runner_method.substr(0, runner_method.size() - 4);
+    else if (grasp)
+      runner_method = runner_method.substr(0, runner_method.size() - 6);
+
+    if (runner_method == string("CAR_SA"))
+      runner = &RA_car_sa;
+    else if (runner_method == string("CAR_TS"))
+      runner = &RA_car_ts;
+    else if (runner_method == string("CAR_HC"))
+      runner = &RA_car_hc;
+    else if (runner_method == string("CAR_SD"))
+      runner = &RA_car_sd;
+    else if (runner_method == string("ARR_SA"))
+      runner = &RA_arr_sa;
+    else if (runner_method == string("ARR_TS"))
+      runner = &RA_arr_ts;
+    else if (runner_method == string("ARR_HC"))
+      runner = &RA_arr_hc;
+    else if (runner_method == string("ARR_SD"))
+      runner = &RA_arr_sd;
+    else if (runner_method == string("CAR_SA_TB") || runner_method == string("ARR_SA_TB"))
+    { // the cooling schedule of the time-based annealing is driven by the solver timeout
+      double timeout;
+      try
+      {
+        RA_solver.GetParameterValue("timeout", timeout);
+      }
+      catch (ParameterNotSet&)
+      {
+        cerr << "method " << string(method) << " requires the solver timeout (--RA solver::timeout)" << endl;
+        exit(1);
+      }
+      if (runner_method == string("CAR_SA_TB"))
+        runner = &RA_car_sa_tb;
+      else
+        runner = &RA_arr_sa_tb;
+      runner->SetParameter("allowed_running_time", timeout);
+    }
     else
     {
       cerr << "unrecognized method " << string(method) << endl;
       exit(1);
     }
 
-    SolverResult<RA_Input,RA_Output,DefaultCostStructure<int>> result = RA_solver.Solve();
+    RA_solver.SetRunner(*runner);
+
+    unique_ptr<RA_Telemetry> telemetry;
+    if (telemetry_file.IsSet())
+    {
+      vector<string> component_names;
+      for (size_t i = 0; i < RA_sm.CostComponents(); i++)
+        component_names.push_back(RA_sm.GetCostComponent(i).name);
+      telemetry.reset(new RA_Telemetry(telemetry_file, telemetry_interval.IsSet() ? static_cast<unsigned long>(telemetry_interval) : 1000UL, component_names));
+    }
+
+    SolverResult<RA_Input,RA_Output,DefaultCostStructure<int>> result(RA_Output(in), DefaultCostStructure<int>(), 0.0);
+    if (iterated)
+    {
+      RA_ils.SetRunner(*runner);
+      RA_ils.SetKicker(RA_arr_kicker);
+      RA_PROFILE_SCOPE("Main: iterated local search");
+      result = RA_ils.Solve();
+    }
+    else if (grasp)
+    { // one copy of the runner for each thread, the helpers are shared
+      unsigned int num_threads = max(threads.IsSet() ? static_cast<unsigned int>(threads) : thread::hardware_concurrency(), 1u); // threads >= 1, checked above
+      for (unsigned int t = 1; t <= num_threads; t++)
+      {
+        grasp_runners.emplace_back(NewRunner(runner_method, in, RA_sm, RA_car_nhe, RA_arr_nhe, "RA GRASP runner " + to_string(t)));
+        CommandLineParameters::Parametrized::RegisterParameters();
+        grasp_runners.back()->CopyParameterValues(*runner);
+        RA_grasp.AddRunner(*grasp_runners.back());
+      }
+      RA_PROFILE_SCOPE("Main: GRASP");
+      result = RA_grasp.Solve();
+    }
+    else if (window_days.IsSet())
+    { // solve the windows in parallel, repair their boundaries and the global terms of the objective
+      auto start = chrono::high_resolution_clock::now();
+      RA_Decomposition decomposition(in, window_days, threads.IsSet() ? static_cast<unsigned int>(threads) : thread::hardware_concurrency());
+      RA_Output merged(in);
+      bool random_initial_state = true;
+
+      RA_solver.GetParameterValue("random_state", random_initial_state);
+      {
+        RA_PROFILE_SCOPE("Main: decomposition windows");
+        decomposition.Solve(merged, runner_method, *runner, random_initial_state, RA_sm);
+        decomposition.RepairBoundaries(merged);
+      }
+
+      // the final hill climbing works on the whole instance
+      Runner<RA_Input, RA_State>& final_runner = runner_method.substr(0, 3) == "CAR" ? static_cast<Runner<RA_Input, RA_State>&>(RA_car_hc) : RA_arr_hc;
+      final_runner.SetParameter("max_idle_iterations", final_idle_iterations.IsSet() ? static_cast<unsigned long>(final_idle_iterations) : 10000UL);
+      RA_solver.SetRunner(final_runner);
+      {
+        RA_PROFILE_SCOPE("Main: decomposition final hill climbing");
+        result = RA_solver.Resolve(merged);
+      }
+      result.running_time = chrono::duration_cast<chrono::duration<double>>(chrono::high_resolution_clock::now() - start).count();
+    }
+    else
+    {
+      RA_PROFILE_SCOPE("Main: solver");
+      result = RA_solver.Solve();
+    }
+    if (telemetry)
+      telemetry->Stop();
     // result is a tuple: 0: solution, 1: number of violations, 2: total cost, 3: computing time
     RA_Output out = result.output;
-    if (output_file.IsSet())
-    { // write the output on the file passed in the command line
-      ofstream os(static_cast<string>(output_file).c_str());
-      os << out << endl;
-      os << "Cost: " << result.cost.total << endl;
-      os << "Violations: " << result.cost.violations << endl;
-			os << "Time: " << result.running_time << "s " << endl;
-      os.close();
+    DefaultCostStructure<int> cost = result.cost;
+    if (polish.IsSet() && polish)
+    { // reassign each date to optimality, keeping only the improving ones
+      RA_PROFILE_SCOPE("Main: polish");
+      MatchingRA matching(in);
+      RA_State st(in);
+      matching.Polish(out);
+      RA_om.InputState(st, out);
+      cost = RA_sm.CostFunctionComponents(st);
     }
+    string format = output_format.IsSet() ? static_cast<string>(output_format) : "text";
+    if (format != "text" && cost.all_components.size() != RA_sm.CostComponents())
+    { // the components are not reported by every solver
+      RA_State st(in);
+      RA_om.InputState(st, out);
+      cost = RA_sm.CostFunctionComponents(st);
+    }
+    ofstream of;
+    if (output_file.IsSet())
+      of.open(static_cast<string>(output_file).c_str());
+    // write the output on the file passed in the command line, or in the standard output
+    ostream& os = output_file.IsSet() ? of : cout;
+    if (format == "json" || format == "csv")
+      PrintStructuredResult(os, format, instance, method, in, RA_sm, out, cost, result.running_time);
     else
-    { // write the solution in the standard output
-      cout << out << endl;
-      cout << "Cost: " << result.cost.total << endl;
-      cout << "Violations: " << result.cost.violations << endl;
-			cout << "Time: " << result.running_time << "s " << endl;					
+    {
+      os << out << '\n';
+      os << "Cost: " << cost.total << '\n';
+      os << "Violations: " << cost.violations << '\n';
+      os << "Time: " << result.running_time << "s " << '\n';
+      if (grasp)
+      {
+        PrintCostDistribution(os, "GRASP constructions", RA_grasp.ConstructionCosts());
+        PrintCostDistribution(os, "GRASP local optima", RA_grasp.DescentCosts());
+      }
     }
+    os.flush();
+    // the profile (with -DRA_PROFILE) on the standard error
+    RA_PROFILE_PRINT(cerr, format == "json");
   }
   return 0;
 }
@@ -0,0 +1,98 @@
+// File RA_Profiler.hh
+#ifndef RA_PROFILER_HH
+#define RA_PROFILER_HH
+
+/*  Profiling counters of the hot paths (cost and delta cost components,
+    neighborhood explorer methods, state copies and the phases of the main),
+    compiled only with -DRA_PROFILE (see PROFILE in the Makefile): without it
+    the macros expand to nothing. Each RA_PROFILE_SCOPE(name) counts the calls
+    of its block and their (inclusive) time, RA_PROFILE_REJECTION() counts a
+    rejection (e.g. a random move drawn again) in the current scope, and
+    RA_PROFILE_PRINT(os, json) writes the summary. The counters are atomic, so
+    they can be shared by the threads of GRASP and of the decomposition.
+*/
+
+#ifdef RA_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+class RA_ProfileCounter
+{
+public:
+  RA_ProfileCounter(const char* n) : name(n), calls(0), nanoseconds(0), rejections(0)
+  {
+    lock_guard<mutex> lock(Mutex());
+    Counters().push_back(this);
+  }
+  static vector<RA_ProfileCounter*>& Counters() { static vector<RA_ProfileCounter*> counters; return counters; }
+  static mutex& Mutex() { static mutex m; return m; }
+  static void Print(ostream& os, bool json);
+
+  const char* name;
+  atomic<unsigned long> calls, nanoseconds, rejections;
+};
+
+class RA_ProfileScope
+{
+public:
+  RA_ProfileScope(RA_ProfileCounter& c) : counter(c), start(chrono::steady_clock::now()) {}
+  ~RA_ProfileScope()
+  {
+    counter.calls.fetch_add(1, memory_order_relaxed);
+    counter.nanoseconds.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count(), memory_order_relaxed);
+  }
+  bool Reject() { counter.rejections.fetch_add(1, memory_order_relaxed); return true; }
+
+private:
+  RA_ProfileCounter& counter;
+  chrono::steady_clock::time_point start;
+};
+
+// the counters sorted by decreasing time, as a table or as a JSON array
+inline void RA_ProfileCounter::Print(ostream& os, bool json)
+{
+  vector<RA_ProfileCounter*> counters;
+  {
+    lock_guard<mutex> lock(Mutex());
+    counters = Counters();
+  }
+  sort(counters.begin(), counters.end(), [](const RA_ProfileCounter* c1, const RA_ProfileCounter* c2) { return c1->nanoseconds > c2->nanoseconds; });
+
+  if (json)
+  {
+    os << "[";
+    for (size_t i = 0; i < counters.size(); i++)
+      os << (i > 0 ? ",\n " : "\n ") << "{\"name\": \"" << counters[i]->name << "\", \"calls\": " << counters[i]->calls
+         << ", \"ns\": " << counters[i]->nanoseconds << ", \"rejections\": " << counters[i]->rejections << "}";
+    os << "\n]" << endl;
+  }
+  else
+  {
+    os << left << setw(58) << "profile" << right << setw(14) << "calls" << setw(14) << "total ms" << setw(12) << "ns/call" << setw(14) << "rejections" << endl;
+    for (const RA_ProfileCounter* c : counters)
+      if (c->calls > 0)
+        os << left << setw(58) << c->name << right << setw(14) << c->calls << setw(14) << fixed << setprecision(1) << c->nanoseconds / 1e6
+           << setw(12) << setprecision(0) << static_cast<double>(c->nanoseconds) / c->calls << setw(14) << c->rejections << endl;
+  }
+}
+
+#define RA_PROFILE_SCOPE(name) static RA_ProfileCounter ra_profile_counter(name); RA_ProfileScope ra_profile_scope(ra_profile_counter)
+#define RA_PROFILE_REJECTION() ra_profile_scope.Reject()
+#define RA_PROFILE_PRINT(os, json) RA_ProfileCounter::Print(os, json)
+
+#else
+
+#define RA_PROFILE_SCOPE(name)
+#define RA_PROFILE_REJECTION() true
+#define RA_PROFILE_PRINT(os, json)
+
+#endif
+
+#endif
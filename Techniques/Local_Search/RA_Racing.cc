@@ -0,0 +1,71 @@
+// File RA_Racing.cc
+#include "RA_Racing.hh"
+#include <cmath>
+#include <algorithm>
+
+double NormalQuantile(double p)
+{
+  double low = -10.0, high = 10.0;
+  for (int i = 0; i < 100; i++)
+  {
+    double mid = (low + high) / 2;
+    if (0.5 * erfc(-mid / sqrt(2.0)) < p)
+      low = mid;
+    else
+      high = mid;
+  }
+  return (low + high) / 2;
+}
+
+double ChiSquareQuantile(double p, double df)
+{
+  double z = NormalQuantile(p), a = 2.0 / (9.0 * df);
+  return df * pow(1.0 - a + z * sqrt(a), 3);
+}
+
+double StudentQuantile(double p, double df)
+{
+  double z = NormalQuantile(p);
+  return z + (pow(z, 3) + z) / (4 * df) + (5 * pow(z, 5) + 16 * pow(z, 3) + 3 * z) / (96 * df * df);
+}
+
+void FriedmanRanks(const vector<vector<double>>& costs, unsigned blocks, vector<double>& rank_sums, double& sum_squared_ranks)
+{
+  unsigned k = costs.size();
+
+  rank_sums.assign(k, 0.0);
+  sum_squared_ranks = 0.0;
+  for (unsigned b = 0; b < blocks; b++)
+  {
+    vector<unsigned> order(k);
+    for (unsigned i = 0; i < k; i++)
+      order[i] = i;
+    sort(order.begin(), order.end(), [&](unsigned i, unsigned j) { return costs[i][b] < costs[j][b]; });
+    for (unsigned i = 0; i < k; )
+    {
+      unsigned j = i;
+      while (j + 1 < k && costs[order[j + 1]][b] == costs[order[i]][b])
+        j++;
+      double rank = (i + j) / 2.0 + 1.0;
+      for (unsigned l = i; l <= j; l++)
+      {
+        rank_sums[order[l]] += rank;
+        sum_squared_ranks += rank * rank;
+      }
+      i = j + 1;
+    }
+  }
+}
+
+// without ties A = n k (k + 1) (2k + 1) / 6, and T is the usual 12 / (n k (k + 1)) sum_j R_j^2 - 3 n (k + 1)
+double FriedmanStatistic(const vector<double>& rank_sums, unsigned blocks, double sum_squared_ranks)
+{
+  double n = blocks, k = rank_sums.size(), sum_squared_rank_sums = 0.0;
+  double c = n * k * (k + 1) * (k + 1) / 4.0;
+
+  for (double r : rank_sums)
+    sum_squared_rank_sums += r * r;
+  if (sum_squared_ranks - c <= 0.0)
+    return 0.0; // all ties
+  return (k - 1) * (sum_squared_rank_sums - n * c) / (sum_squared_ranks - c);
+}
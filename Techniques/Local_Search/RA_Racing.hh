@@ -0,0 +1,23 @@
+// File RA_Racing.hh
+#ifndef RA_RACING_HH
+#define RA_RACING_HH
+
+#include <vector>
+
+using namespace std;
+
+/*  The statistics of the racing of RA_Tuning.cc: the Friedman test on the
+    ranks of the costs of k configurations in n blocks, and the quantiles of
+    the distributions of its test and of the Conover post-hoc test.
+*/
+
+double NormalQuantile(double p); // of the standard normal distribution (by bisection)
+double ChiSquareQuantile(double p, double df); // with df degrees of freedom (Wilson-Hilferty)
+double StudentQuantile(double p, double df); // with df degrees of freedom (Cornish-Fisher)
+
+// the rank sums R_j of the configurations and the sum A of all the squared ranks, ranking the costs[j][b] of each block b (the ties have the mean of their ranks)
+void FriedmanRanks(const vector<vector<double>>& costs, unsigned blocks, vector<double>& rank_sums, double& sum_squared_ranks);
+// T = (k - 1) (sum_j R_j^2 - n^2 k (k + 1)^2 / 4) / (A - n k (k + 1)^2 / 4), 0 when each block is all ties
+double FriedmanStatistic(const vector<double>& rank_sums, unsigned blocks, double sum_squared_ranks);
+
+#endif
@@ -0,0 +1,126 @@
+// File RA_Telemetry.cc
+#include "RA_Telemetry.hh"
+
+atomic<RA_Telemetry*> RA_Telemetry::active(nullptr);
+
+// the capacity is rounded up to a power of two
+RA_Telemetry::RA_Telemetry(const string& file_name, unsigned long i, const vector<string>& names, size_t capacity)
+  : os(file_name), interval(max(i, 1UL)), component_names(names), start(chrono::steady_clock::now()),
+    enqueue_position(0), dequeue_position(0), dropped(0), stopping(false)
+{
+  size_t size = 2;
+
+  if (!os)
+    throw runtime_error("Cannot open telemetry file " + file_name);
+  while (size < capacity)
+    size *= 2;
+  buffer = vector<Cell>(size);
+  mask = size - 1;
+  for (size_t p = 0; p < size; p++)
+    buffer[p].sequence.store(p, memory_order_relaxed);
+
+  writer = thread(&RA_Telemetry::Write, this);
+  active.store(this, memory_order_release);
+}
+
+void RA_Telemetry::Stop()
+{
+  RA_Telemetry* self = this;
+
+  active.compare_exchange_strong(self, nullptr);
+  if (writer.joinable())
+  {
+    stopping.store(true, memory_order_release);
+    writer.join();
+    os.flush();
+  }
+}
+
+unsigned RA_Telemetry::Register(const string& runner_name)
+{
+  lock_guard<mutex> lock(runners_mutex);
+  runner_names.push_back(runner_name);
+  return runner_names.size() - 1;
+}
+
+// a cell can be written when its sequence is equal to the position, and read when it is position + 1
+bool RA_Telemetry::Push(const RA_TelemetryRecord& r)
+{
+  size_t position = enqueue_position.load(memory_order_relaxed);
+  Cell* cell;
+
+  while (true)
+  {
+    cell = &buffer[position & mask];
+    size_t sequence = cell->sequence.load(memory_order_acquire);
+    long difference = static_cast<long>(sequence) - static_cast<long>(position);
+    if (difference == 0)
+    {
+      if (enqueue_position.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+    { // full
+      dropped.fetch_add(1, memory_order_relaxed);
+      return false;
+    }
+    else
+      position = enqueue_position.load(memory_order_relaxed);
+  }
+  cell->record = r;
+  cell->sequence.store(position + 1, memory_order_release);
+  return true;
+}
+
+// single consumer (the writer thread)
+bool RA_Telemetry::Pop(RA_TelemetryRecord& r)
+{
+  size_t position = dequeue_position.load(memory_order_relaxed);
+  Cell& cell = buffer[position & mask];
+
+  if (cell.sequence.load(memory_order_acquire) != position + 1)
+    return false;
+  r = cell.record;
+  cell.sequence.store(position + mask + 1, memory_order_release);
+  dequeue_position.store(position + 1, memory_order_relaxed);
+  return true;
+}
+
+void RA_Telemetry::Write()
+{
+  RA_TelemetryRecord r;
+
+  while (true)
+  {
+    bool last = stopping.load(memory_order_acquire); // the records pushed before the stop are still written
+    while (Pop(r))
+      WriteRecord(r);
+    if (last)
+      break;
+    os.flush();
+    this_thread::sleep_for(chrono::milliseconds(20));
+  }
+  if (dropped.load(memory_order_relaxed) > 0)
+    os << "{\"dropped\": " << dropped.load(memory_order_relaxed) << "}\n";
+}
+
+void RA_Telemetry::WriteRecord(const RA_TelemetryRecord& r)
+{
+  string runner;
+  {
+    lock_guard<mutex> lock(runners_mutex);
+    runner = runner_names[r.runner];
+  }
+
+  os << "{\"time\": " << r.time << ", \"runner\": \"" << runner << "\", \"run\": " << r.run << ", \"iteration\": " << r.iteration
+     << ", \"temperature\": ";
+  if (std::isnan(r.temperature))
+    os << "null";
+  else
+    os << r.temperature;
+  os << ", \"cost\": " << r.cost << ", \"violations\": " << r.violations
+     << ", \"best_cost\": " << r.best_cost << ", \"best_violations\": " << r.best_violations << ", \"components\": {";
+  for (unsigned i = 0; i < r.num_components; i++)
+    os << (i > 0 ? ", \"" : "\"") << (i < component_names.size() ? component_names[i] : "cc" + to_string(i + 1)) << "\": " << r.components[i];
+  os << "}, \"acceptance_rate\": " << r.acceptance_rate << "}\n";
+}
@@ -0,0 +1,161 @@
+// File RA_Telemetry.hh
+#ifndef RA_TELEMETRY_HH
+#define RA_TELEMETRY_HH
+
+#include "RA_Helpers.hh"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <cmath>
+
+/*  Trajectory telemetry of the runners: every interval iterations (and at the
+    end of each run) a runner records its time, iteration, temperature (for the
+    annealing runners), current and best cost, current cost components and the
+    acceptance rate of the last interval. The records are pushed on a bounded
+    lock-free ring buffer (Vyukov's multi-producer queue, so that the threads
+    of GRASP and of the decomposition can share it) and written as JSON lines
+    by a separate thread; when the buffer is full the record is dropped (and
+    counted) instead of stalling the search. The runners are wrapped by
+    RA_TelemetryRunner, which does nothing while no telemetry is active.
+*/
+
+struct RA_TelemetryRecord
+{
+  static const unsigned MAX_COMPONENTS = 12;
+
+  double time, temperature, acceptance_rate; // temperature NAN for the runners without it
+  unsigned long iteration;
+  unsigned runner, run;
+  int cost, violations, best_cost, best_violations;
+  unsigned num_components;
+  int components[MAX_COMPONENTS];
+};
+
+class RA_Telemetry
+{
+public:
+  RA_Telemetry(const string& file_name, unsigned long interval, const vector<string>& component_names, size_t capacity = 1 << 14);
+  ~RA_Telemetry() { Stop(); }
+  void Stop(); // writes the pending records and closes the file (idempotent)
+
+  static RA_Telemetry* Active() { return active.load(memory_order_acquire); }
+  unsigned long Interval() const { return interval; }
+  double Elapsed() const { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); }
+  unsigned Register(const string& runner_name);
+  bool Push(const RA_TelemetryRecord& r);
+  unsigned long Dropped() const { return dropped.load(memory_order_relaxed); }
+
+private:
+  struct Cell
+  {
+    atomic<size_t> sequence;
+    RA_TelemetryRecord record;
+  };
+
+  bool Pop(RA_TelemetryRecord& r);
+  void Write();
+  void WriteRecord(const RA_TelemetryRecord& r);
+
+  static atomic<RA_Telemetry*> active;
+
+  ofstream os;
+  unsigned long interval;
+  vector<string> component_names;
+  chrono::steady_clock::time_point start;
+
+  vector<Cell> buffer;
+  size_t mask;
+  atomic<size_t> enqueue_position, dequeue_position;
+  atomic<unsigned long> dropped;
+
+  mutex runners_mutex; // guards runner_names, written by Register and read by the writer
+  vector<string> runner_names;
+
+  atomic<bool> stopping;
+  thread writer;
+};
+
+/*  BaseRunner extended with the telemetry samples. The temperature is read
+    only from the runners that have one (the simulated annealing family).
+*/
+template <class BaseRunner>
+class RA_TelemetryRunner : public BaseRunner
+{
+public:
+  using BaseRunner::BaseRunner;
+
+protected:
+  void InitializeRun()
+  {
+    BaseRunner::InitializeRun();
+    telemetry = RA_Telemetry::Active();
+    if (telemetry == nullptr)
+      return;
+    runs++;
+    if (registered_in != telemetry)
+    {
+      id = telemetry->Register(this->name);
+      registered_in = telemetry;
+    }
+    accepted = 0;
+    last_iteration = 0;
+    Sample();
+  }
+
+  void TerminateRun()
+  {
+    if (telemetry != nullptr && this->iteration != last_iteration)
+      Sample();
+    BaseRunner::TerminateRun();
+  }
+
+  void MakeMove()
+  {
+    accepted++;
+    BaseRunner::MakeMove();
+  }
+
+  void CompleteIteration()
+  {
+    BaseRunner::CompleteIteration();
+    if (telemetry != nullptr && this->iteration % telemetry->Interval() == 0)
+      Sample();
+  }
+
+private:
+  void Sample()
+  {
+    RA_TelemetryRecord r;
+    const vector<int>& components = this->current_state_cost.all_components;
+
+    r.time = telemetry->Elapsed();
+    r.temperature = Temperature(*this, 0);
+    r.acceptance_rate = this->iteration > last_iteration ? static_cast<double>(accepted) / (this->iteration - last_iteration) : 0.0;
+    r.iteration = this->iteration;
+    r.runner = id;
+    r.run = runs;
+    r.cost = this->current_state_cost.total;
+    r.violations = this->current_state_cost.violations;
+    r.best_cost = this->best_state_cost.total;
+    r.best_violations = this->best_state_cost.violations;
+    r.num_components = min<size_t>(components.size(), RA_TelemetryRecord::MAX_COMPONENTS);
+    copy(components.begin(), components.begin() + r.num_components, r.components);
+    telemetry->Push(r);
+
+    accepted = 0;
+    last_iteration = this->iteration;
+  }
+
+  template <class Runner>
+  static auto Temperature(const Runner& r, int) -> decltype(static_cast<double>(r.temperature)) { return r.temperature; }
+  static double Temperature(const RA_TelemetryRunner&, long) { return NAN; }
+
+  RA_Telemetry* telemetry = nullptr;
+  RA_Telemetry* registered_in = nullptr;
+  unsigned id = 0, runs = 0;
+  unsigned long accepted = 0, last_iteration = 0;
+};
+
+#endif
@@ -0,0 +1,313 @@
+// File RA_Tuning.cc
+#include "RA_Decomposition.hh"
+#include "RA_Racing.hh"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <numeric>
+
+/*  Tuning of the simulated annealing (start temperature, temperature range
+    and cooling rate, on the grid of batch_SA.py) with racing. Each instance is
+    read once, and each block (an instance and a repetition, with its seed)
+    runs all the surviving configurations in parallel from a copy of the
+    same random initial state, built once from the seed of the block. After the first blocks, the configurations are compared with
+    the Friedman test on the ranks of their costs in the blocks and, when it is
+    significant, the configurations worse than the best one according to the
+    Conover post-hoc test are dropped (the F-race). Each run is logged in the
+    CSV file with the columns of the log of batch_SA.py.
+*/
+
+struct SA_Configuration
+{
+  double start_temperature, min_temperature, cooling_rate;
+  unsigned neighbors_sampled, neighbors_accepted;
+  bool alive;
+  vector<double> costs; // one for each block
+};
+
+// the helpers of one instance, shared by the threads, and one runner for each thread
+class RA_TuningInstance
+{
+public:
+  RA_TuningInstance(const string& file_name, const string& method, unsigned threads);
+  const RA_Input& Input() const { return in; }
+  void InitialState(unsigned seed, RA_State& st); // the random state of the seed, in the calling thread
+  DefaultCostStructure<int> Run(unsigned thread, const SA_Configuration& c, const RA_State& initial, unsigned seed);
+  const string file_name;
+protected:
+  const RA_Input in;
+
+  RA_CostComponents components;
+
+  RA_StateManager sm;
+  ChangeAssignedRefereesNeighborhoodExplorer car_nhe;
+  AddRemoveRefereeNeighborhoodExplorer arr_nhe;
+  vector<unique_ptr<Runner<RA_Input,RA_State>>> runners;
+};
+
+RA_TuningInstance::RA_TuningInstance(const string& f, const string& method, unsigned threads)
+  : file_name(f), in(ReadInstance(f)),
+    components(in), sm(in), car_nhe(in, sm), arr_nhe(in, sm)
+{
+  components.Attach(sm, car_nhe, arr_nhe);
+
+  // the runners are created (and registered in the parameters) by the main thread only
+  for (unsigned t = 1; t <= threads; t++)
+    runners.emplace_back(NewRunner(method, in, sm, car_nhe, arr_nhe, f + " tuning runner " + to_string(t)));
+}
+
+void RA_TuningInstance::InitialState(unsigned seed, RA_State& st)
+{
+  Random::SetThreadSeed(seed);
+  sm.RandomState(st);
+}
+
+// a run from a copy of the initial state, in the calling thread (the moves drawn from the seed)
+DefaultCostStructure<int> RA_TuningInstance::Run(unsigned thread, const SA_Configuration& c, const RA_State& initial, unsigned seed)
+{
+  Runner<RA_Input,RA_State>& runner = *runners[thread];
+  RA_State st(in);
+
+  runner.SetParameter("start_temperature", c.start_temperature);
+  runner.SetParameter("min_temperature", c.min_temperature);
+  runner.SetParameter("cooling_rate", c.cooling_rate);
+  runner.SetParameter("neighbors_sampled", c.neighbors_sampled);
+  runner.SetParameter("neighbors_accepted", c.neighbors_accepted);
+
+  st = initial;
+  Random::SetThreadSeed(seed);
+  return runner.Go(st);
+}
+
+/***************************************************************************
+ * Racing
+ ***************************************************************************/
+
+/* The Friedman test over the blocks of the surviving configurations, and the
+   Conover post-hoc test against the best ranked one; returns the number of
+   configurations dropped.
+*/
+unsigned Race(vector<SA_Configuration>& configurations, unsigned blocks, double alpha)
+{
+  vector<unsigned> alive;
+  for (unsigned c = 0; c < configurations.size(); c++)
+    if (configurations[c].alive)
+      alive.push_back(c);
+
+  unsigned k = alive.size(), dropped = 0;
+  double n = blocks, sum_squared_ranks, sum_squared_rank_sums = 0.0, conover;
+  vector<vector<double>> costs;
+  vector<double> rank_sums;
+
+  if (k < 2 || blocks < 2)
+    return 0;
+
+  for (unsigned c : alive)
+    costs.push_back(configurations[c].costs);
+  FriedmanRanks(costs, blocks, rank_sums, sum_squared_ranks);
+  if (FriedmanStatistic(rank_sums, blocks, sum_squared_ranks) <= ChiSquareQuantile(1.0 - alpha, k - 1))
+    return 0; // also when all the costs of each block are tied
+  for (double r : rank_sums)
+    sum_squared_rank_sums += r * r;
+
+  unsigned best = min_element(rank_sums.begin(), rank_sums.end()) - rank_sums.begin();
+  conover = StudentQuantile(1.0 - alpha / 2, (n - 1) * (k - 1))
+    * sqrt(2.0 * (n * sum_squared_ranks - sum_squared_rank_sums) / ((n - 1) * (k - 1)));
+  for (unsigned i = 0; i < k; i++)
+    if (rank_sums[i] - rank_sums[best] > conover)
+    {
+      configurations[alive[i]].alive = false;
+      dropped++;
+    }
+  return dropped;
+}
+
+vector<double> ParseList(const string& s)
+{
+  vector<double> values;
+  istringstream is(s);
+  string value;
+
+  while (getline(is, value, ','))
+    values.push_back(stod(value));
+  return values;
+}
+
+int main(int argc, const char* argv[])
+{
+  string method = "CAR_SA", instance_directory = "../../RefAssign-Instances/Instances", log_file;
+  vector<string> instance_names = { "RA-1-8.txt", "RA-1-10.txt", "RA-2-16.txt", "RA-2-20.txt", "RA-3-24.txt",
+                                    "RA-3-30.txt", "RA-4-32.txt", "RA-4-40.txt", "RA-5-40.txt", "RA-5-50.txt" };
+  vector<double> start_temperatures = { 10.0, 100.0, 1000.0 }, temperature_ranges = { 10.0, 30.0, 100.0 },
+    cooling_rates = { 0.95, 0.99, 0.995, 0.999 };
+  unsigned threads = max(thread::hardware_concurrency(), 1u), repetitions = 1, seed = 1, first_test = 5;
+  double total_iterations = 4E08, alpha = 0.05;
+  bool instances_set = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+    if (arg == "-method" && i + 1 < argc)
+      method = argv[++i];
+    else if (arg == "-threads" && i + 1 < argc)
+      threads = max(stoul(argv[++i]), 1UL);
+    else if (arg == "-repetitions" && i + 1 < argc)
+      repetitions = stoul(argv[++i]);
+    else if (arg == "-seed" && i + 1 < argc)
+      seed = stoul(argv[++i]);
+    else if (arg == "-iterations" && i + 1 < argc)
+      total_iterations = stod(argv[++i]);
+    else if (arg == "-start_temp" && i + 1 < argc)
+      start_temperatures = ParseList(argv[++i]);
+    else if (arg == "-range_temp" && i + 1 < argc)
+      temperature_ranges = ParseList(argv[++i]);
+    else if (arg == "-cooling_rate" && i + 1 < argc)
+      cooling_rates = ParseList(argv[++i]);
+    else if (arg == "-first_test" && i + 1 < argc)
+      first_test = stoul(argv[++i]);
+    else if (arg == "-alpha" && i + 1 < argc)
+      alpha = stod(argv[++i]);
+    else if (arg == "-log" && i + 1 < argc)
+      log_file = argv[++i];
+    else if (arg == "-instance_directory" && i + 1 < argc)
+      instance_directory = argv[++i];
+    else if (arg[0] != '-')
+    {
+      if (!instances_set)
+        instance_names.clear();
+      instances_set = true;
+      instance_names.push_back(arg);
+    }
+    else
+    {
+      cerr << "Usage: " << argv[0] << " [-method CAR_SA|ARR_SA] [-threads n] [-repetitions n] [-seed n] [-iterations total]" << endl
+           << "    [-start_temp t1,t2,...] [-range_temp r1,r2,...] [-cooling_rate c1,c2,...] [-first_test blocks] [-alpha level]" << endl
+           << "    [-log file.csv] [-instance_directory dir] [instance_file...]" << endl;
+      return 1;
+    }
+  }
+  if (method != "CAR_SA" && method != "ARR_SA")
+  {
+    cerr << "The tuned method must be CAR_SA or ARR_SA" << endl;
+    return 1;
+  }
+  if (log_file.empty())
+  { // as batch_SA.py, one log for each day
+    char today[11];
+    time_t now = time(nullptr);
+    strftime(today, sizeof(today), "%Y-%m-%d", localtime(&now));
+    log_file = string("Log_") + today + ".csv";
+  }
+
+  // the instances are read once, the missing ones are skipped as in batch_SA.py
+  vector<unique_ptr<RA_TuningInstance>> instances;
+  for (const string& name : instance_names)
+  {
+    string path = name.find('/') == string::npos ? instance_directory + "/" + name : name;
+    if (!ifstream(path))
+    {
+      cerr << "Skipping the missing instance " << path << endl;
+      continue;
+    }
+    instances.emplace_back(new RA_TuningInstance(path, method, threads));
+  }
+  if (instances.empty())
+  {
+    cerr << "No instances" << endl;
+    return 1;
+  }
+  CommandLineParameters::Parametrized::RegisterParameters();
+
+  // the grid, with the number of neighbors of batch_SA.py
+  vector<SA_Configuration> configurations;
+  for (double st : start_temperatures)
+    for (double tr : temperature_ranges)
+      for (double cr : cooling_rates)
+      {
+        SA_Configuration c;
+        double number_of_temperatures = -log(tr) / log(cr);
+        c.start_temperature = st;
+        c.min_temperature = st / tr;
+        c.cooling_rate = cr;
+        c.neighbors_sampled = static_cast<unsigned>(round(total_iterations / number_of_temperatures));
+        c.neighbors_accepted = static_cast<unsigned>(c.neighbors_sampled * 0.1);
+        c.alive = true;
+        configurations.push_back(c);
+      }
+
+  ofstream log(log_file, ios::app);
+  if (!log)
+  {
+    cerr << "Cannot open the log file " << log_file << endl;
+    return 1;
+  }
+  log << "Trial,Instance,Cost,Seed,Time,Start_temp,Min_Temp,Cooling_Rate" << endl;
+
+  mt19937 seeds(seed);
+  unsigned blocks = 0, alive = configurations.size();
+  for (unsigned r = 0; r < repetitions && alive > 1; r++)
+    for (unsigned i = 0; i < instances.size() && alive > 1; i++)
+    {
+      RA_TuningInstance& instance = *instances[i];
+      unsigned block_seed = seeds() % 100000000;
+      RA_State initial(instance.Input());
+      vector<unsigned> tasks;
+      atomic<unsigned> next_task(0);
+      mutex log_mutex;
+      vector<thread> workers;
+
+      instance.InitialState(block_seed, initial);
+      for (unsigned c = 0; c < configurations.size(); c++)
+        if (configurations[c].alive)
+          tasks.push_back(c);
+
+      // each worker takes the next configuration with its own runner
+      for (unsigned t = 0; t < min<size_t>(threads, tasks.size()); t++)
+        workers.emplace_back([&, t]() {
+          unsigned task;
+          while ((task = next_task++) < tasks.size())
+          {
+            SA_Configuration& c = configurations[tasks[task]];
+            auto start = chrono::steady_clock::now();
+            DefaultCostStructure<int> cost = instance.Run(t, c, initial, block_seed);
+            double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            lock_guard<mutex> lock(log_mutex);
+            c.costs.push_back(cost.total); // one cost for each block, the workers join at the end of the block
+            log << r << ',' << instance.file_name.substr(instance.file_name.find_last_of('/') + 1) << ',' << cost.total << ','
+                << block_seed << ',' << time << ',' << c.start_temperature << ',' << c.min_temperature << ',' << c.cooling_rate << '\n';
+          }
+        });
+      for (thread& w : workers)
+        w.join();
+      log.flush();
+      blocks++;
+
+      if (blocks >= first_test)
+      {
+        unsigned dropped = Race(configurations, blocks, alpha);
+        alive -= dropped;
+        cout << "Block " << blocks << " (" << instance.file_name << ", trial " << r << "): "
+             << alive << " configurations alive (" << dropped << " dropped)" << endl;
+      }
+      else
+        cout << "Block " << blocks << " (" << instance.file_name << ", trial " << r << ")" << endl;
+    }
+
+  // the surviving configurations, by mean cost
+  vector<unsigned> survivors;
+  for (unsigned c = 0; c < configurations.size(); c++)
+    if (configurations[c].alive)
+      survivors.push_back(c);
+  auto mean = [&](unsigned c) { return accumulate(configurations[c].costs.begin(), configurations[c].costs.end(), 0.0) / configurations[c].costs.size(); };
+  sort(survivors.begin(), survivors.end(), [&](unsigned c1, unsigned c2) { return mean(c1) < mean(c2); });
+
+  cout << "Surviving configurations (start_temp, min_temp, cooling_rate: mean cost over " << blocks << " blocks):" << endl;
+  for (unsigned c : survivors)
+    cout << "  " << configurations[c].start_temperature << ", " << configurations[c].min_temperature << ", "
+         << configurations[c].cooling_rate << ": " << round(mean(c) * 10) / 10 << endl;
+  return 0;
+}
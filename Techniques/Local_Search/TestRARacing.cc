@@ -0,0 +1,48 @@
+// File TestRARacing.cc
+#include "RA_Racing.hh"
+#include <iostream>
+#include <cmath>
+
+/*  The Friedman statistic on examples computed by hand: 4 blocks of 3
+    configurations, without and with ties.
+*/
+
+bool Check(const string& name, double value, double expected)
+{
+  bool ok = fabs(value - expected) < 1e-9;
+  cout << name << ": " << value << " (expected " << expected << ")" << (ok ? "" : " WRONG") << endl;
+  return ok;
+}
+
+int main()
+{
+  vector<vector<double>> costs = {{10, 12, 10, 15}, {20, 11, 20, 16}, {30, 30, 30, 40}};
+  vector<double> rank_sums;
+  double sum_squared_ranks;
+  bool ok = true;
+
+  // the ranks are (1,2,3), (2,1,3), (1,2,3), (1,2,3): R = (5,7,12), A = 4 * 14 = 56,
+  // T = 2 * (25 + 49 + 144 - 16 * 12 * 16 / 4) / (56 - 4 * 3 * 16 / 4) = 2 * 26 / 8 = 6.5
+  FriedmanRanks(costs, 4, rank_sums, sum_squared_ranks);
+  ok &= Check("R_1", rank_sums[0], 5.0);
+  ok &= Check("R_2", rank_sums[1], 7.0);
+  ok &= Check("R_3", rank_sums[2], 12.0);
+  ok &= Check("A", sum_squared_ranks, 56.0);
+  ok &= Check("T", FriedmanStatistic(rank_sums, 4, sum_squared_ranks), 6.5);
+
+  // the last block tied (1.5,1.5,3): R = (5.5,6.5,12), A = 42 + 13.5 = 55.5,
+  // T = 2 * (30.25 + 42.25 + 144 - 192) / (55.5 - 48) = 49 / 7.5
+  costs[1][3] = 15;
+  FriedmanRanks(costs, 4, rank_sums, sum_squared_ranks);
+  ok &= Check("R_1 (ties)", rank_sums[0], 5.5);
+  ok &= Check("R_2 (ties)", rank_sums[1], 6.5);
+  ok &= Check("A (ties)", sum_squared_ranks, 55.5);
+  ok &= Check("T (ties)", FriedmanStatistic(rank_sums, 4, sum_squared_ranks), 49.0 / 7.5);
+
+  // all the blocks tied
+  costs = {{1, 2}, {1, 2}, {1, 2}};
+  FriedmanRanks(costs, 2, rank_sums, sum_squared_ranks);
+  ok &= Check("T (all ties)", FriedmanStatistic(rank_sums, 2, sum_squared_ranks), 0.0);
+
+  return ok ? 0 : 1;
+}
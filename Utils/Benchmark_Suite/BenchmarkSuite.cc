@@ -0,0 +1,448 @@
+// File BenchmarkSuite.cc
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <dirent.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/*	Scaling and regression benchmark of the techniques over the instance corpus
+	(and the generated instances in Generated/, see the Makefile). Each run is
+	a separate process with a fixed seed and a time limit; its standard output
+	and error are read line by line, so that the improvements it reports (the
+	new best states of the local search, the new best solutions of the
+	backtracking) are timestamped. For each run the cost, the violations, the
+	time, the time to target (the first time the cost of the baseline, or the
+	final cost without a baseline, has been reached) and the peak resident
+	set size are written in a CSV file, and compared with the baseline.
+*/
+
+struct Technique {
+	string name;
+	string executable;			// relative to the directory of the suite
+	vector<string> arguments;	// %instance, %seed and %evaluations are replaced
+	int maxGames;				// only the (tractable) instances with at most maxGames games, 0 for all
+	double timeLimit;			// seconds, 0 for the time limit of the suite
+};
+
+struct Result {
+	string technique, instance, status;
+	int games = 0;
+	unsigned seed = 0;
+	long long cost = -1, violations = -1;	// -1 when not reported
+	double time = 0.0, timeToTarget = -1.0;	// -1 when the target has not been reached
+	long peakRss = 0;						// KB
+};
+
+const string TECHNIQUES = "../../Techniques/";
+
+vector<Technique> DefaultTechniques() {
+	const string localSearch = TECHNIQUES + "Local_Search/TestRALocalSearch.exe";
+	vector<Technique> techniques = {
+		{ "Greedy", TECHNIQUES + "Greedy/RA_Driver.exe", { "%instance", "1", "1", "1", "1", "1", "1", "1", "shuffle", "%seed" }, 0, 0.0 },
+		{ "Backtracking", TECHNIQUES + "Backtracking/TestRABacktracking.exe", { "%instance", "1", "1", "1", "1", "1", "1", "1" }, 150, 10.0 }
+	};
+	const vector<pair<string, string>> runners = {
+		{ "CAR_SA", "ChangeAssignedReferees_SimulatedAnnealing" }, { "ARR_SA", "AddRemoveReferee_SimulatedAnnealing" },
+		{ "CAR_TS", "ChangeAssignedReferees_TabuSearch" }, { "ARR_TS", "AddRemoveReferee_TabuSearch" }
+	};
+
+	// the tabu search explores the whole neighborhood at each iteration: only on the smaller instances
+	for (const pair<string, string>& r : runners) {
+		Technique t = { r.first, localSearch, { "--main::instance", "%instance", "--main::method", r.first, "--main::seed", "%seed",
+												"--" + r.second + "::max_evaluations", "%evaluations" }, r.first == "CAR_TS" ? 150 : r.first == "ARR_TS" ? 1000 : 0, 0.0 };
+		if (r.first.substr(4) == "SA")
+			t.arguments.insert(t.arguments.end(), { "--" + r.second + "::start_temperature", "100", "--" + r.second + "::min_temperature", "1",
+													"--" + r.second + "::cooling_rate", "0.99", "--" + r.second + "::neighbors_sampled", "1000",
+													"--" + r.second + "::neighbors_accepted", "100" });
+		else
+			t.arguments.insert(t.arguments.end(), { "--" + r.second + "::max_idle_iterations", "100", "--" + r.second + "::min_tenure", "5",
+													"--" + r.second + "::max_tenure", "10" });
+		techniques.push_back(t);
+	}
+
+	return techniques;
+}
+
+// the text files of a directory, sorted by name (none if the directory does not exist)
+vector<string> ListInstances(const string& directory) {
+	vector<string> files;
+	DIR *dir = opendir(directory.c_str());
+
+	if (dir == nullptr)
+		return files;
+	while (struct dirent *entry = readdir(dir)) {
+		string name = entry->d_name;
+		if (name.size() > 4 && name.substr(name.size() - 4) == ".txt")
+			files.push_back(directory + "/" + name);
+	}
+	closedir(dir);
+	sort(files.begin(), files.end());
+
+	return files;
+}
+
+// the number of games declared in the header of an instance, 0 if it cannot be read
+int NumGames(const string& fileName) {
+	ifstream is(fileName);
+	string line;
+
+	while (getline(is, line))
+		if (line.compare(0, 5, "Games") == 0 && line.find('=') != string::npos)
+			return atoi(line.c_str() + line.find('=') + 1);
+
+	return 0;
+}
+
+// the number following prefix in line, if any
+bool NumberAfter(const string& line, const string& prefix, long long& value) {
+	size_t p = line.find(prefix);
+
+	if (p == string::npos)
+		return false;
+	p += prefix.size();
+	if (p >= line.size() || (!isdigit(line[p]) && line[p] != '-'))
+		return false;
+	value = atoll(line.c_str() + p);
+
+	return true;
+}
+
+/*	The costs reported by the techniques: "Cost: c" at the end (greedy, local
+	search), "c (viol: v, ...)" for each new best state of the local search
+	(on the standard error), "(current cost c" for each new best solution of
+	the backtracking and "(cost c, n nodes visited)" at its end.
+*/
+void ParseLine(const string& line, double time, Result& r, vector<pair<double, long long>>& improvements, long long& finalCost) {
+	long long value;
+
+	if (NumberAfter(line, "Cost: ", value) || NumberAfter(line, "(cost ", value))
+		finalCost = value;
+	else if (NumberAfter(line, "(current cost ", value))
+		improvements.emplace_back(time, value);
+	else if (!line.empty() && isdigit(line[0]) && line.find(" (viol: ") != string::npos) {
+		improvements.emplace_back(time, atoll(line.c_str()));
+		NumberAfter(line, " (viol: ", r.violations);
+	}
+	if (NumberAfter(line, "Violations: ", value) || NumberAfter(line, "violations: ", value))
+		r.violations = value;
+}
+
+Result Run(const Technique& t, const string& instance, unsigned seed, unsigned long evaluations, double timeLimit, long long target) {
+	Result r;
+	vector<string> arguments = { t.executable };
+	vector<char*> argv;
+	vector<pair<double, long long>> improvements;
+	long long finalCost = -1;
+	int fds[2], status;
+	struct rusage usage;
+	string pending;
+	bool timedOut = false;
+
+	r.technique = t.name;
+	r.instance = instance;
+	r.games = NumGames(instance);
+	r.seed = seed;
+	for (const string& a : t.arguments)
+		arguments.push_back(a == "%instance" ? instance : a == "%seed" ? to_string(seed) : a == "%evaluations" ? to_string(evaluations) : a);
+	for (string& a : arguments)
+		argv.push_back(&a[0]);
+	argv.push_back(nullptr);
+
+	if (pipe(fds) != 0)
+		throw runtime_error(string("pipe: ") + strerror(errno));
+
+	auto start = steady_clock::now();
+	pid_t pid = fork();
+	if (pid < 0)
+		throw runtime_error(string("fork: ") + strerror(errno));
+	if (pid == 0) {
+		close(fds[0]);
+		dup2(fds[1], STDOUT_FILENO);
+		dup2(fds[1], STDERR_FILENO);
+		close(fds[1]);
+		execv(argv[0], argv.data());
+		cerr << "Cannot execute " << argv[0] << ": " << strerror(errno) << endl;
+		_exit(127);
+	}
+	close(fds[1]);
+
+	// the output is read as it is written, until the end of the process or the time limit
+	while (true) {
+		double elapsed = duration<double>(steady_clock::now() - start).count();
+		if (!timedOut && elapsed >= timeLimit) {
+			kill(pid, SIGKILL);
+			timedOut = true;
+		}
+
+		struct pollfd p = { fds[0], POLLIN, 0 };
+		int ready = poll(&p, 1, timedOut ? 1000 : max(1, static_cast<int>((timeLimit - elapsed) * 1000)));
+		if (ready < 0 && errno != EINTR)
+			break;
+		if (ready <= 0)
+			continue;
+
+		char buffer[65536];
+		ssize_t n = read(fds[0], buffer, sizeof(buffer));
+		if (n <= 0)
+			break;
+		elapsed = duration<double>(steady_clock::now() - start).count();
+		pending.append(buffer, n);
+		size_t begin = 0, end;
+		while ((end = pending.find('\n', begin)) != string::npos) {
+			ParseLine(pending.substr(begin, end - begin), elapsed, r, improvements, finalCost);
+			begin = end + 1;
+		}
+		pending.erase(0, begin);
+	}
+	close(fds[0]);
+	wait4(pid, &status, 0, &usage);
+	r.time = duration<double>(steady_clock::now() - start).count();
+	if (!pending.empty())
+		ParseLine(pending, r.time, r, improvements, finalCost);
+
+	r.peakRss = usage.ru_maxrss;
+	r.status = timedOut ? "timeout" : WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "ok" : "error";
+	// after a timeout the best cost reported so far
+	r.cost = finalCost >= 0 ? finalCost : improvements.empty() ? -1 : min_element(improvements.begin(), improvements.end(),
+		[](const pair<double, long long>& a, const pair<double, long long>& b) { return a.second < b.second; })->second;
+
+	if (target < 0)
+		target = r.cost;
+	if (r.cost >= 0) {
+		for (const pair<double, long long>& i : improvements)
+			if (i.second <= target) {
+				r.timeToTarget = i.first;
+				break;
+			}
+		if (r.timeToTarget < 0 && r.cost <= target)
+			r.timeToTarget = r.time;
+	}
+
+	return r;
+}
+
+void WriteHeader(ostream& os) {
+	os << "technique,instance,games,seed,status,cost,violations,time,time_to_target,peak_rss_kb" << endl;
+}
+
+void WriteResult(ostream& os, const Result& r) {
+	os << r.technique << ',' << r.instance << ',' << r.games << ',' << r.seed << ',' << r.status << ',';
+	if (r.cost >= 0)
+		os << r.cost;
+	os << ',';
+	if (r.violations >= 0)
+		os << r.violations;
+	os << ',' << r.time << ',';
+	if (r.timeToTarget >= 0)
+		os << r.timeToTarget;
+	os << ',' << r.peakRss << endl;
+}
+
+// the baseline results, by technique and instance
+map<pair<string, string>, Result> ReadBaseline(const string& fileName) {
+	map<pair<string, string>, Result> baseline;
+	ifstream is(fileName);
+	string line;
+	vector<string> header;
+
+	if (!is)
+		throw runtime_error("Cannot open the baseline " + fileName);
+	while (getline(is, line)) {
+		vector<string> fields;
+		stringstream ss(line);
+		string field;
+
+		while (getline(ss, field, ','))
+			fields.push_back(field);
+		if (line.size() > 0 && line.back() == ',')
+			fields.push_back("");
+		if (header.empty()) {
+			header = fields;
+			continue;
+		}
+
+		map<string, string> row;
+		Result r;
+		for (unsigned i = 0; i < header.size() && i < fields.size(); i++)
+			row[header[i]] = fields[i];
+		r.technique = row["technique"];
+		r.instance = row["instance"];
+		r.status = row["status"];
+		r.cost = row["cost"].empty() ? -1 : stoll(row["cost"]);
+		r.violations = row["violations"].empty() ? -1 : stoll(row["violations"]);
+		r.time = row["time"].empty() ? 0.0 : stod(row["time"]);
+		r.timeToTarget = row["time_to_target"].empty() ? -1.0 : stod(row["time_to_target"]);
+		r.peakRss = row["peak_rss_kb"].empty() ? 0 : stol(row["peak_rss_kb"]);
+		baseline[make_pair(r.technique, r.instance)] = r;
+	}
+
+	return baseline;
+}
+
+/*	The regressions of a run with respect to the baseline: a worse status or
+	cost, a slower run (or a slower time to target) and a larger peak memory,
+	beyond the relative tolerances (the times also beyond minTime seconds).
+*/
+vector<string> Compare(const Result& r, const Result& b, double costTolerance, double timeTolerance, double rssTolerance, double minTime) {
+	vector<string> regressions;
+	ostringstream message;
+
+	if (b.status == "ok" && r.status != "ok")
+		regressions.push_back("status " + r.status + " (baseline ok)");
+	if (b.cost >= 0 && (r.cost < 0 || r.cost > b.cost + costTolerance * b.cost))
+		regressions.push_back("cost " + (r.cost < 0 ? string("missing") : to_string(r.cost)) + " (baseline " + to_string(b.cost) + ")");
+	if (r.time > b.time * (1 + timeTolerance) && r.time - b.time > minTime) {
+		message.str("");
+		message << "time " << r.time << " s (baseline " << b.time << " s)";
+		regressions.push_back(message.str());
+	}
+	if (b.timeToTarget >= 0 && (r.timeToTarget < 0 || (r.timeToTarget > b.timeToTarget * (1 + timeTolerance) && r.timeToTarget - b.timeToTarget > minTime))) {
+		message.str("");
+		message << "time to target ";
+		if (r.timeToTarget < 0)
+			message << "not reached";
+		else
+			message << r.timeToTarget << " s";
+		message << " (baseline " << b.timeToTarget << " s)";
+		regressions.push_back(message.str());
+	}
+	if (b.peakRss > 0 && r.peakRss > b.peakRss * (1 + rssTolerance))
+		regressions.push_back("peak RSS " + to_string(r.peakRss) + " KB (baseline " + to_string(b.peakRss) + " KB)");
+
+	return regressions;
+}
+
+vector<string> Split(const string& s) {
+	vector<string> values;
+	istringstream is(s);
+	string value;
+
+	while (getline(is, value, ','))
+		values.push_back(value);
+
+	return values;
+}
+
+int main(int argc, char* argv[]) {
+	string outputFile = "results.csv", baselineFile, instanceDirectory = "../../RefAssign-Instances/Instances";
+	vector<string> instances, selected;
+	unsigned seed = 1;
+	unsigned long evaluations = 100000;
+	double timeLimit = 300.0, costTolerance = 0.0, timeTolerance = 0.25, rssTolerance = 0.25, minTime = 0.2;
+
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "-output" && i + 1 < argc)
+			outputFile = argv[++i];
+		else if (arg == "-baseline" && i + 1 < argc)
+			baselineFile = argv[++i];
+		else if (arg == "-seed" && i + 1 < argc)
+			seed = stoul(argv[++i]);
+		else if (arg == "-evaluations" && i + 1 < argc)
+			evaluations = stoul(argv[++i]);
+		else if (arg == "-time" && i + 1 < argc)
+			timeLimit = stod(argv[++i]);
+		else if (arg == "-cost_tolerance" && i + 1 < argc)
+			costTolerance = stod(argv[++i]);
+		else if (arg == "-time_tolerance" && i + 1 < argc)
+			timeTolerance = stod(argv[++i]);
+		else if (arg == "-rss_tolerance" && i + 1 < argc)
+			rssTolerance = stod(argv[++i]);
+		else if (arg == "-min_time" && i + 1 < argc)
+			minTime = stod(argv[++i]);
+		else if (arg == "-techniques" && i + 1 < argc)
+			selected = Split(argv[++i]);
+		else if (arg == "-instance_directory" && i + 1 < argc)
+			instanceDirectory = argv[++i];
+		else if (arg[0] != '-')
+			instances.push_back(arg);
+		else {
+			cerr << "Usage: " << argv[0] << " [options] [instance_file...]" << endl
+				 << "  -output file           results (results.csv)" << endl
+				 << "  -baseline file         baseline to compare with (none)" << endl
+				 << "  -seed n                seed of the greedy and of the local search (1)" << endl
+				 << "  -evaluations n         cost evaluations of each local search run (100000)" << endl
+				 << "  -time s                time limit of each run (300)" << endl
+				 << "  -cost_tolerance x      allowed relative cost increase (0)" << endl
+				 << "  -time_tolerance x      allowed relative increase of time and time to target (0.25)" << endl
+				 << "  -rss_tolerance x       allowed relative increase of the peak RSS (0.25)" << endl
+				 << "  -min_time s            time increases below s are not regressions (0.2)" << endl
+				 << "  -techniques t1,t2,...  subset of Greedy, Backtracking, CAR_SA, ARR_SA, CAR_TS, ARR_TS (all)" << endl
+				 << "  -instance_directory d  the corpus, when no instance is given (" << instanceDirectory << ")" << endl;
+			return 1;
+		}
+	}
+	if (instances.empty()) {
+		instances = ListInstances(instanceDirectory);
+		for (const string& g : ListInstances("Generated"))
+			instances.push_back(g);
+	}
+
+	vector<Technique> techniques;
+	for (const Technique& t : DefaultTechniques())
+		if (selected.empty() || find(selected.begin(), selected.end(), t.name) != selected.end())
+			techniques.push_back(t);
+	for (const Technique& t : techniques)
+		if (access(t.executable.c_str(), X_OK) != 0) {
+			cerr << "Missing executable " << t.executable << " (make Techniques)" << endl;
+			return 1;
+		}
+
+	map<pair<string, string>, Result> baseline;
+	if (!baselineFile.empty())
+		baseline = ReadBaseline(baselineFile);
+
+	ofstream os(outputFile);
+	if (!os) {
+		cerr << "Cannot open " << outputFile << endl;
+		return 1;
+	}
+	WriteHeader(os);
+
+	unsigned runs = 0, regressions = 0, missing = 0;
+	for (const Technique& t : techniques)
+		for (const string& instance : instances) {
+			if (t.maxGames > 0 && NumGames(instance) > t.maxGames)
+				continue;
+
+			auto b = baseline.find(make_pair(t.name, instance));
+			Result r = Run(t, instance, seed, evaluations, t.timeLimit > 0 ? t.timeLimit : timeLimit, b != baseline.end() ? b->second.cost : -1);
+			WriteResult(os, r);
+			runs++;
+
+			cout << t.name << " " << instance << ": " << r.status << ", cost " << r.cost << ", " << r.time << " s, " << r.peakRss << " KB";
+			if (!baselineFile.empty()) {
+				if (b == baseline.end()) {
+					cout << " (not in the baseline)";
+					missing++;
+				} else
+					for (const string& regression : Compare(r, b->second, costTolerance, timeTolerance, rssTolerance, minTime)) {
+						cout << endl << "  REGRESSION: " << regression;
+						regressions++;
+					}
+			}
+			cout << endl;
+		}
+
+	cout << runs << " runs written in " << outputFile;
+	if (!baselineFile.empty())
+		cout << ", " << regressions << " regressions with respect to " << baselineFile << (missing > 0 ? " (" + to_string(missing) + " runs not in the baseline)" : "");
+	cout << endl;
+
+	return regressions > 0 ? 2 : 0;
+}
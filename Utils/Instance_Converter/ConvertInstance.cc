@@ -0,0 +1,44 @@
+// File ConvertInstance.cc
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <RA_Data.hh>
+#include <RA_Binary.hh>
+
+/*	Converts the instances from the text format to the binary one (or back,
+	with -t), checking that the converted instance reads back the same.
+*/
+int main(int argc, char* argv[]) {
+	bool toText = argc == 4 && string(argv[1]) == "-t";
+	string inputFile, outputFile;
+	ostringstream original, converted;
+
+	if (argc == 3 || toText) {
+		inputFile = argv[argc - 2];
+		outputFile = argv[argc - 1];
+	} else {
+		cerr << "Usage: " << argv[0] << " [-t] input_file output_file" << endl;
+		exit(1);
+	}
+
+	RA_Input in = ReadInstance(inputFile);
+
+	if (toText) {
+		ofstream os(outputFile);
+		os << in;
+	} else
+		RA_BinaryInstance::Write(in, outputFile);
+
+	RA_Input out = ReadInstance(outputFile);
+
+	original << in;
+	converted << out;
+	if (original.str() != converted.str()) {
+		cerr << "The instance " << outputFile << " differs from " << inputFile << endl;
+		exit(1);
+	}
+
+	return 0;
+}
@@ -0,0 +1,278 @@
+// File GenerateInstance.cc
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <sstream>
+#include <random>
+#include <climits>
+#include <stdexcept>
+#include <RA_Data.hh>
+#include <RA_Binary.hh>
+
+/*	Generator of synthetic instances: each division plays a (single or
+	double) round robin, one round per weekend with its games spread on
+	Friday, Saturday and Sunday. The teams play in the arena of their own,
+	assigned cyclically (team t in arena (t - 1) mod arenas + 1, hence shared
+	by the teams that are arenas apart when there are fewer arenas), and
+	the arenas and the referees' homes are placed uniformly on the 50x50
+	square or, with -clusters k, around k centers. The numbers are drawn
+	from the 32 bit values of mt19937 (fully specified by the standard), so
+	the same seed gives the same instance everywhere.
+*/
+class Generator {
+
+public:
+	Generator(unsigned seed) : rng(seed) {}
+	int Integer(int a, int b) { return a + static_cast<int>(rng() % static_cast<unsigned>(b - a + 1)); }	// in [a, b]
+	double Real(double a, double b) { return a + (b - a) * (rng() / 4294967296.0); }	// in [a, b)
+	bool Probability(double p) { return Real(0, 1) < p; }
+	int Count(double mean) { int n = static_cast<int>(mean); return n + (Probability(mean - n) ? 1 : 0); }	// integer part of mean, plus one with the probability of the fraction
+	vector<int> Distinct(int n, int a, int b, int excluded = 0);	// n distinct integers in [a, b] except excluded (fewer if there are not enough)
+	Coordinates2D Point(const vector<Coordinates2D>& centers, double spread);
+
+private:
+	mt19937 rng;
+
+};
+
+Coordinates2D Generator::Point(const vector<Coordinates2D>& centers, double spread) {
+	const double side = 50;
+	double x, y;
+
+	if (centers.empty())
+		return Coordinates2D(Real(0, side), Real(0, side));
+
+	// approximately normal around the center (sum of three uniforms)
+	const Coordinates2D& c = centers[Integer(0, centers.size() - 1)];
+	x = c.X() + spread * (Real(-1, 1) + Real(-1, 1) + Real(-1, 1));
+	y = c.Y() + spread * (Real(-1, 1) + Real(-1, 1) + Real(-1, 1));
+
+	return Coordinates2D(min(max(x, 0.0), side), min(max(y, 0.0), side));
+}
+
+vector<int> Generator::Distinct(int n, int a, int b, int excluded) {
+	vector<int> values;
+	int available = b - a + 1 - (excluded >= a && excluded <= b ? 1 : 0);
+
+	while (static_cast<int>(values.size()) < min(n, available)) {
+		int v = Integer(a, b - (excluded >= a && excluded <= b ? 1 : 0));
+
+		if (excluded >= a && excluded <= b && v >= excluded)
+			v++;
+		if (find(values.begin(), values.end(), v) == values.end())
+			values.push_back(v);
+	}
+	sort(values.begin(), values.end());
+
+	return values;
+}
+
+void Usage(const char* program) {
+	cerr << "Usage: " << program << " [options] output_file" << endl
+	     << "  -seed n                 random seed (1)" << endl
+	     << "  -divisions n            number of divisions (5)" << endl
+	     << "  -teams n                teams of each division (12)" << endl
+	     << "  -referees n             number of referees (as many as the teams)" << endl
+	     << "  -arenas n               number of arenas (half the teams)" << endl
+	     << "  -rounds n               1: single, 2: double round robin (2)" << endl
+	     << "  -clusters n             geographic clusters, 0: uniform (0)" << endl
+	     << "  -unavailabilities x     average unavailabilities of each referee (3)" << endl
+	     << "  -incompatibilities x    average incompatible referees, and teams, of each referee (0.1)" << endl
+	     << "  -start d/m/y            first Friday of the season (4/1/2019)" << endl
+	     << "  -binary                 write the binary format (see RA_Binary.hh)" << endl;
+	exit(1);
+}
+
+// the whole value as a number in [low, high], otherwise the usage
+long long IntegerOption(const string& value, const char* program, long long low = INT_MIN, long long high = INT_MAX) {
+	size_t end = 0;
+	long long n = 0;
+
+	try {
+		n = stoll(value, &end);
+	} catch (const logic_error&) {
+		Usage(program);
+	}
+	if (end != value.size() || n < low || n > high)
+		Usage(program);
+
+	return n;
+}
+
+double RealOption(const string& value, const char* program) {
+	size_t end = 0;
+	double x = 0;
+
+	try {
+		x = stod(value, &end);
+	} catch (const logic_error&) {
+		Usage(program);
+	}
+	if (end != value.size())
+		Usage(program);
+
+	return x;
+}
+
+int main(int argc, char* argv[]) {
+	map<string, string> options = { {"-seed", "1"}, {"-divisions", "5"}, {"-teams", "12"}, {"-referees", "0"}, {"-arenas", "0"}, {"-rounds", "2"},
+	                                {"-clusters", "0"}, {"-unavailabilities", "3"}, {"-incompatibilities", "0.1"}, {"-start", "4/1/2019"} };
+	bool binary = false;
+	string outputFile;
+
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+
+		if (arg == "-binary")
+			binary = true;
+		else if (options.count(arg) && i + 1 < argc)
+			options[arg] = argv[++i];
+		else if (arg[0] != '-' && i == argc - 1)
+			outputFile = arg;
+		else
+			Usage(argv[0]);
+	}
+	if (outputFile.empty())
+		Usage(argv[0]);
+
+	unsigned seed = static_cast<unsigned>(IntegerOption(options["-seed"], argv[0], 0, UINT_MAX));
+	int numDivisions = IntegerOption(options["-divisions"], argv[0]), teamsPerDivision = IntegerOption(options["-teams"], argv[0]);
+	int refereesOption = IntegerOption(options["-referees"], argv[0]), arenasOption = IntegerOption(options["-arenas"], argv[0]);
+	int rounds = IntegerOption(options["-rounds"], argv[0]), numClusters = IntegerOption(options["-clusters"], argv[0]);
+	double unavailabilities = RealOption(options["-unavailabilities"], argv[0]), incompatibilities = RealOption(options["-incompatibilities"], argv[0]);
+	int d, m, y;
+	char ch1, ch2;
+	istringstream date(options["-start"]);
+
+	// an invalid date is built as 1/1/1
+	if (!(date >> d >> ch1 >> m >> ch2 >> y) || ch1 != '/' || ch2 != '/' || date.peek() != EOF || Date(d, m, y).Year() != y)
+		Usage(argv[0]);
+	if (numDivisions < 1 || teamsPerDivision < 2 || static_cast<long long>(numDivisions) * teamsPerDivision > INT_MAX || (rounds != 1 && rounds != 2)
+		|| refereesOption < 0 || arenasOption < 0 || numClusters < 0 || unavailabilities < 0 || unavailabilities > 10000 || incompatibilities < 0) {
+		cerr << "Invalid options: at least one division of two teams, one or two rounds, no negative number, at most 10000 unavailabilities" << endl;
+		exit(1);
+	}
+
+	Generator gen(seed);
+	Date start(d, m, y);
+	int numTeams = numDivisions * teamsPerDivision;
+	int numReferees = refereesOption > 0 ? refereesOption : numTeams;
+	int numArenas = arenasOption > 0 ? min(arenasOption, numTeams) : max(1, numTeams / 2);
+
+	// no more incompatibilities than referees or teams
+	incompatibilities = min(incompatibilities, static_cast<double>(max(numReferees, numTeams)));
+
+	vector<Coordinates2D> centers;
+	for (int c = 0; c < numClusters; c++)
+		centers.push_back(Coordinates2D(gen.Real(5, 45), gen.Real(5, 45)));
+	// the spread shrinks with the number of clusters
+	double spread = numClusters > 0 ? 10.0 / numClusters + 1 : 0;
+
+	vector<Division> divisions;
+	for (int i = 1; i <= numDivisions; i++) {
+		int minReferees = gen.Integer(1, 2);
+		divisions.push_back(Division(i, minReferees, minReferees + gen.Integer(0, 1), gen.Integer(1, 3), teamsPerDivision));
+	}
+
+	vector<Arena> arenas;
+	for (int i = 1; i <= numArenas; i++)
+		arenas.push_back(Arena(i, gen.Point(centers, spread)));
+
+	vector<Team> teams;
+	for (int i = 1; i <= numTeams; i++)
+		teams.push_back(Team(i, (i - 1) / teamsPerDivision + 1));
+
+	// round robin (circle method), with a dummy team for the byes
+	int weeks = 0;
+	vector<Game> games;
+	for (int div = 1; div <= numDivisions; div++) {
+		int n = teamsPerDivision + teamsPerDivision % 2, firstTeam = (div - 1) * teamsPerDivision + 1;
+		vector<int> circle(n);
+
+		for (int i = 0; i < n; i++)
+			circle[i] = i;
+		weeks = max(weeks, rounds * (n - 1));
+
+		for (int r = 0; r < n - 1; r++) {
+			for (int i = 0; i < n / 2; i++) {
+				int home = circle[i], away = circle[n - 1 - i];
+
+				if (home >= teamsPerDivision || away >= teamsPerDivision)
+					continue;
+				// the fixed team alternates home and away games
+				if ((i == 0 && r % 2 == 1) || (i > 0 && i % 2 == 1))
+					swap(home, away);
+
+				for (int leg = 0; leg < rounds; leg++) {
+					int h = firstTeam + (leg == 0 ? home : away), a = firstTeam + (leg == 0 ? away : home);
+					Date date = start + (7 * (leg * (n - 1) + r) + gen.Integer(0, 2));
+					Time time = Time(17, 0) + 15 * gen.Integer(0, 16);
+
+					games.push_back(Game(h, a, div, Event(date, time), (h - 1) % numArenas + 1, gen.Integer(4, 6)));
+				}
+			}
+			rotate(circle.begin() + 1, circle.end() - 1, circle.end());
+		}
+	}
+
+	vector<Referee> referees;
+	for (int i = 1; i <= numReferees; i++) {
+		vector<Event> unavailable;
+		int numUnavailabilities = gen.Integer(0, static_cast<int>(2 * unavailabilities + 0.5));
+		vector<int> incompatibleReferees = gen.Distinct(numReferees > 1 ? gen.Count(incompatibilities) : 0, 1, numReferees, i);
+		vector<int> incompatibleTeams = gen.Distinct(gen.Count(incompatibilities), 1, numTeams);
+
+		for (int u = 0; u < numUnavailabilities; u++) {
+			Date date = start + gen.Integer(0, 7 * weeks);
+			Time from(12 + gen.Integer(0, 8), 15 * gen.Integer(0, 3));
+			int duration = min(120 + 15 * gen.Integer(0, 24), 23 * 60 + 45 - from.TimeInMinutes());
+
+			unavailable.push_back(Event(date, from, date, from + duration));
+		}
+		sort(unavailable.begin(), unavailable.end(), less_equal<Event>());
+
+		referees.push_back(Referee(i, gen.Integer(2, 5), gen.Point(centers, spread), gen.Integer(8, 12), incompatibleReferees, incompatibleTeams, unavailable));
+	}
+
+	ofstream os(outputFile);
+	if (!os) {
+		cerr << "Cannot open file " << outputFile << endl;
+		exit(1);
+	}
+
+	os << "Divisions = " << numDivisions << ";" << endl;
+	os << "Referees = " << numReferees << ";" << endl;
+	os << "Arenas = " << numArenas << ";" << endl;
+	os << "Teams = " << numTeams << ";" << endl;
+	os << "Games = " << games.size() << ";" << endl;
+	os << endl << "DIVISIONS % code, min referees, max referees, level, teams" << endl;
+	for (const Division& x : divisions)
+		os << x << '\n';
+	os << endl << "REFEREES % code, level, coordinates, experience, incompatible referees, incompatible teams, unavailabilities" << endl;
+	for (const Referee& x : referees)
+		os << x << '\n';
+	os << endl << "ARENAS % code, coordinates" << endl;
+	for (const Arena& x : arenas)
+		os << x << '\n';
+	os << endl << "TEAMS % code, division" << endl;
+	for (const Team& x : teams)
+		os << x << '\n';
+	os << endl << "GAMES % Home team, guest team, division, date, time, arena, experience" << endl;
+	for (const Game& x : games)
+		os << x << '\n';
+	os.close();
+
+	// the instance is read back (checking it), and converted if requested
+	RA_Input in = ReadInstance(outputFile);
+	if (binary)
+		RA_BinaryInstance::Write(in, outputFile);
+
+	cout << outputFile << ": " << in.NumDivisions() << " divisions, " << in.NumTeams() << " teams, " << in.NumGames() << " games, "
+	     << in.NumDates() << " dates, " << in.NumReferees() << " referees, " << in.NumArenas() << " arenas" << endl;
+
+	return 0;
+}
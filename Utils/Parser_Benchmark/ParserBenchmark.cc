@@ -0,0 +1,116 @@
+// File ParserBenchmark.cc
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <RA_Data.hh>
+#include <RA_Parser.hh>
+
+/*	Writes a synthetic text instance with the given number of games (ten
+	teams per division, a referee every four games of a date), only meant
+	to measure the loading time.
+*/
+void WriteInstance(int numGames, const string& fileName) {
+	const int gamesPerDate = 40, teamsPerDivision = 10;
+	int numDivisions = max(1, numGames / 1000), numTeams = numDivisions * teamsPerDivision, numArenas = numTeams / 2, numReferees = gamesPerDate / 4 * 3;
+	mt19937 rng(1);
+	uniform_real_distribution<double> coordinate(0, 50);
+	ofstream os(fileName);
+	Date date(1, 1, 2019);
+
+	os << "Divisions = " << numDivisions << ";" << endl << "Referees = " << numReferees << ";" << endl << "Arenas = " << numArenas << ";" << endl
+	   << "Teams = " << numTeams << ";" << endl << "Games = " << numGames << ";" << endl << endl;
+
+	os << "DIVISIONS % code, min referees, max referees, level, teams" << endl;
+	for (int d = 1; d <= numDivisions; d++)
+		os << "D" << d << ": " << 1 + rng() % 2 << ", " << 2 + rng() % 2 << ", " << 1 + rng() % 3 << ", " << teamsPerDivision << endl;
+
+	os << endl << "REFEREES % code, level, coordinates, experience, incompatible referees, incompatible teams, unavailabilities" << endl;
+	for (int r = 1; r <= numReferees; r++) {
+		os << "R" << r << ", " << 1 + rng() % 5 << ", (" << coordinate(rng) << ", " << coordinate(rng) << "), " << 8 + rng() % 5 << ", [";
+		if (r % 10 == 0)
+			os << "R" << 1 + rng() % numReferees;
+		os << "], [";
+		if (r % 5 == 0)
+			os << "T" << 1 + rng() % numTeams;
+		os << "], [" << 1 + rng() % 28 << "/" << 1 + rng() % 12 << "/2019 " << 12 + rng() % 6 << ":" << 15 * (rng() % 4) << "-23:45]" << endl;
+	}
+
+	os << endl << "ARENAS % code, coordinates" << endl;
+	for (int a = 1; a <= numArenas; a++)
+		os << "A" << a << " (" << coordinate(rng) << ", " << coordinate(rng) << ")" << endl;
+
+	os << endl << "TEAMS % code, division" << endl;
+	for (int t = 1; t <= numTeams; t++)
+		os << "T" << t << " D" << (t - 1) / teamsPerDivision + 1 << endl;
+
+	os << endl << "GAMES % home team, away team, division, date, time, arena, experience" << endl;
+	for (int g = 0; g < numGames; g++) {
+		int division = rng() % numDivisions, home = rng() % teamsPerDivision, away = (home + 1 + rng() % (teamsPerDivision - 1)) % teamsPerDivision;
+
+		if (g > 0 && g % gamesPerDate == 0)
+			++date;
+		os << "T" << division * teamsPerDivision + home + 1 << " T" << division * teamsPerDivision + away + 1 << " D" << division + 1 << " "
+		   << date << " " << 12 + rng() % 9 << ":" << 15 * (rng() % 4) << " A" << (division * teamsPerDivision + home) / 2 + 1 << " " << 4 + rng() % 6 << endl;
+	}
+}
+
+/*	Loads an instance (or a synthetic one of num_games games, with -g) with
+	the extractors and with the parser, checks that the two agree and prints
+	the best time of each one over the repetitions.
+*/
+int main(int argc, char* argv[]) {
+	string fileName;
+	int repetitions = 5;
+	double extractorTime = 1e100, parserTime = 1e100;
+	ostringstream extracted, parsed;
+
+	if (argc >= 4 && string(argv[1]) == "-g") {
+		fileName = argv[3];
+		WriteInstance(stoi(argv[2]), fileName);
+		if (argc == 5)
+			repetitions = stoi(argv[4]);
+	} else if (argc == 2 || argc == 3) {
+		fileName = argv[1];
+		if (argc == 3)
+			repetitions = stoi(argv[2]);
+	} else {
+		cerr << "Usage: " << argv[0] << " [-g num_games] instance_file [repetitions]" << endl;
+		exit(1);
+	}
+
+	try {
+		for (int i = 0; i < repetitions; i++) {
+			// the parser first, as the extractors may crash on a malformed instance
+			auto start = chrono::steady_clock::now();
+			RA_Input parserInput(fileName);
+			auto middle = chrono::steady_clock::now();
+			ifstream is(fileName);
+			RA_Input extractorInput(is);
+			auto end = chrono::steady_clock::now();
+
+			parserTime = min(parserTime, chrono::duration<double>(middle - start).count());
+			extractorTime = min(extractorTime, chrono::duration<double>(end - middle).count());
+			if (i == 0) {
+				extracted << extractorInput;
+				parsed << parserInput;
+			}
+		}
+	} catch (const RA_ParseError& e) {
+		cerr << e.what() << endl;
+		exit(1);
+	}
+
+	if (extracted.str() != parsed.str()) {
+		cerr << "The parser and the extractors read " << fileName << " differently" << endl;
+		exit(1);
+	}
+
+	cout << "Extractors: " << extractorTime * 1000 << " ms" << endl;
+	cout << "Parser: " << parserTime * 1000 << " ms (" << extractorTime / parserTime << "x)" << endl;
+
+	return 0;
+}
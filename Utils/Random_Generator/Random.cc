@@ -1,14 +1,35 @@
 #include <ctime>
 #include <cstdlib>
 #include <random>
+#include <algorithm>
 #include "Random.hh"
 using namespace std;
 
+static mt19937& Generator()  // one engine per thread
+{
+  thread_local random_device rd;
+  thread_local mt19937 gen(rd());
+  return gen;
+}
+
 int Random(int a, int b)
 { 
-  static random_device rd;
-  static mt19937 gen(rd());
   uniform_int_distribution<int> dis(a,b);
-  return dis(gen);
+  return dis(Generator());
+}
+
+double Random(double a, double b)
+{
+  uniform_real_distribution<double> dis(a,b);
+  return dis(Generator());
 }
 
+void SetRandomSeed(unsigned seed)
+{
+  Generator().seed(seed);
+}
+
+void RandomShuffle(vector<int>& v)
+{
+  shuffle(v.begin(), v.end(), Generator());
+}
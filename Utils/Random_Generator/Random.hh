@@ -2,7 +2,11 @@
 #ifndef RANDOM_HH
 #define RANDOM_HH
 #include <random>
+#include <vector>
 
 int Random(int,int);
+double Random(double,double);
+void SetRandomSeed(unsigned); // of the calling thread, otherwise seeded by random_device
+void RandomShuffle(std::vector<int>&); // with the engine of the calling thread, unlike random_shuffle
 
 #endif
@@ -124,7 +124,7 @@ protected:
           cur++;
           goto loop;
         }
-        catch (EmptyNeighborhood e)
+        catch (EmptyNeighborhood &)
         {
           backtracking = true;
           cur--;
@@ -187,7 +187,7 @@ protected:
           cur++;
           goto loop;
         }
-        catch (EmptyNeighborhood e)
+        catch (EmptyNeighborhood &)
         {
           backtracking = true;
           cur--;
@@ -226,7 +226,7 @@ protected:
     {
       FirstKick();
     }
-    catch (EmptyNeighborhood)
+    catch (EmptyNeighborhood &)
     {
       end = true;
     }
@@ -351,7 +351,7 @@ protected:
           cur++;
           goto loop;
         }
-        catch (EmptyNeighborhood e)
+        catch (EmptyNeighborhood &)
         {
           backtracking = true;
           cur--;
@@ -389,7 +389,7 @@ protected:
     {
       RandomKick();
     }
-    catch (EmptyNeighborhood)
+    catch (EmptyNeighborhood &)
     {
       end = true;
     }
@@ -441,7 +441,7 @@ public:
     for (FullKickerIterator<Input, State, Move, CostStructure> it = begin(length, st); it != end(length, st); ++it)
     {
       CostStructure cost(0, 0, 0, std::vector<CFtype>(sm.CostComponents(), 0));
-      for (int i = 0; i < it->size(); i++)
+      for (size_t i = 0; i < it->size(); i++)
       {
         if (!(*it)[i].first.is_valid)
         {
@@ -471,7 +471,7 @@ public:
     for (FullKickerIterator<Input, State, Move, CostStructure> it = begin(length, st); it != end(length, st); ++it)
     {
       CostStructure cost(0, 0, 0, std::vector<CFtype>(sm.CostComponents(), 0));
-      for (int i = 0; i < it->size(); i++)
+      for (size_t i = 0; i < it->size(); i++)
       {
         if (!(*it)[i].first.is_valid)
         {
@@ -506,7 +506,7 @@ public:
   {
     SampleKickerIterator<Input, State, Move, CostStructure> random_it = sample_begin(length, st, 1);
     CostStructure cost(0, 0, 0, std::vector<CFtype>(sm.CostComponents(), 0));
-    for (int i = 0; i < random_it->size(); i++)
+    for (size_t i = 0; i < random_it->size(); i++)
     {
       if (!(*random_it)[i].first.is_valid)
       {
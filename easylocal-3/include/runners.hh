@@ -32,6 +32,7 @@
 #include "runners/simulatedannealing.hh"
 #include "runners/abstractsimulatedannealing.hh"
 #include "runners/simulatedannealingevaluationbased.hh"
+#include "runners/simulatedannealingtimebased.hh"
 #include "runners/simulatedannealingwithreheating.hh"
 #include "runners/greatdeluge.hh"
 #include "runners/tabusearch.hh"
@@ -3,6 +3,8 @@
 #include <cmath>
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
+#include <vector>
 
 #include "runners/moverunner.hh"
 #include "helpers/statemanager.hh"
@@ -43,6 +45,8 @@ namespace EasyLocal
       // parameters
       void InitializeParameters();
       Parameter<bool> compute_start_temperature;
+      Parameter<unsigned int> start_temperature_samples;
+      Parameter<double> start_acceptance_ratio;
       Parameter<double> start_temperature;
       Parameter<double> cooling_rate;
       Parameter<unsigned int> max_neighbors_sampled, max_neighbors_accepted;
@@ -60,19 +64,23 @@ namespace EasyLocal
     {
       MoveRunner<Input, State, Move, CostStructure>::InitializeParameters();
       compute_start_temperature("compute_start_temperature", "Should the runner compute the initial temperature?", this->parameters);
+      start_temperature_samples("start_temperature_samples", "Number of random moves sampled to compute the initial temperature", this->parameters);
+      start_acceptance_ratio("start_acceptance_ratio", "Expected acceptance ratio of worsening moves at the initial temperature", this->parameters);
       start_temperature("start_temperature", "Starting temperature", this->parameters);
       cooling_rate("cooling_rate", "Cooling rate", this->parameters);
       max_neighbors_sampled("neighbors_sampled", "Maximum number of neighbors sampled at each temp.", this->parameters);
       max_neighbors_accepted("neighbors_accepted", "Maximum number of neighbor accepted at each temp.", this->parameters);
-      if (!compute_start_temperature.IsSet())
-        compute_start_temperature = false; // FIXME!!
+      compute_start_temperature = false;
+      start_temperature_samples = 100;
+      start_acceptance_ratio = 0.8;
     }
     
     /**
      Initializes the run by invoking the companion superclass method, and
-     setting the temperature to the start value.
+     setting the temperature to the start value. If its computation is
+     requested (compute_start_temperature), the start temperature is estimated
+     from a sample of random moves of the current state.
      */
-    // FIXME
     template <class Input, class State, class Move, class CostStructure>
     void AbstractSimulatedAnnealing<Input, State, Move, CostStructure>::InitializeRun()
     {
@@ -89,26 +97,50 @@ namespace EasyLocal
       }
       else
       {
-        // Compute a start temperature by sampling the search space and computing the variance
-        // according to [van Laarhoven and Aarts, 1987] (allow an acceptance ratio of approximately 80%)
-        //State sampled_state(this->in);
-        const unsigned int samples = 100;
-        std::vector<CostStructure> cost_values(samples);
+        if (start_temperature_samples == 0)
+          throw IncorrectParameterValue(start_temperature_samples, "should be greater than zero");
+        if (start_acceptance_ratio <= 0.0 || start_acceptance_ratio >= 1.0)
+          throw IncorrectParameterValue(start_acceptance_ratio, "should be a value in the interval ]0, 1[");
+        
+        // Compute a start temperature such that the average worsening move of the
+        // current state is accepted with the given probability, i.e.,
+        // exp(-mean / T) = start_acceptance_ratio [Kirkpatrick et al., 1983]
         double mean = 0.0, variance = 0.0;
-        for (unsigned int i = 0; i < samples; i++)
+        unsigned int worsening = 0;
+        std::vector<double> delta_values;
+        delta_values.reserve(start_temperature_samples);
+        for (unsigned int i = 0; i < start_temperature_samples; i++)
         {
-          //this->sm.RandomState(sampled_state);
           Move mv;
-          this->ne.RandomMove(*this->p_current_state, mv);
-          cost_values[i] = this->ne.DeltaCostFunctionComponents(*this->p_current_state, mv);
-          mean += cost_values[i].total;
+          try
+          {
+            this->ne.RandomMove(*this->p_current_state, mv);
+          }
+          catch (EmptyNeighborhood&)
+          {
+            break;
+          }
+          delta_values.push_back(static_cast<double>(this->ne.DeltaCostFunctionComponents(*this->p_current_state, mv, this->weights).total));
+          if (delta_values.back() > 0)
+          {
+            mean += delta_values.back();
+            worsening++;
+          }
         }
-        mean /= samples;
-        for (unsigned int i = 0; i < samples; i++)
-          variance += (cost_values[i].total - mean) * (cost_values[i].total - mean) / samples;
-        temperature = variance;
-        /*From "An improved annealing scheme for the QAP. Connoly. EJOR 46 (1990) 93-100"
-         temperature = min(cost_values.begin(), cost_values.end()) + (max(cost_values.begin(), cost_values.end()) - min(cost_values.begin(), cost_values.end()))/10;*/
+        this->evaluations += delta_values.size();
+        if (worsening > 0)
+          temperature = -(mean / worsening) / log(start_acceptance_ratio);
+        else if (delta_values.empty())
+          temperature = 1.0; // empty neighborhood: no move will be accepted anyway
+        else
+        {
+          // No worsening move sampled: fall back to the standard deviation of the deltas
+          mean = std::accumulate(delta_values.begin(), delta_values.end(), 0.0) / delta_values.size();
+          for (double d : delta_values)
+            variance += (d - mean) * (d - mean) / delta_values.size();
+          temperature = std::max(sqrt(variance), 1.0);
+        }
+        start_temperature = temperature;
       }
       
       // If the number of maximum accepted neighbors for each temperature is not set, default to all of them
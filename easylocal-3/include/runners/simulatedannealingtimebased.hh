@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+
+#include "runners/abstractsimulatedannealing.hh"
+
+namespace EasyLocal
+{
+
+  namespace Core
+  {
+
+    /** Implements the Simulated annealing runner with a cooling schedule
+     driven by the wall clock. The number of neighbors sampled at each
+     temperature is recomputed at every cooling step from the measured
+     evaluation rate, in such a way that the minimum temperature is reached
+     when the allowed running time expires.
+
+     @ingroup Runners
+     */
+    template <class Input, class State, class Move, class CostStructure = DefaultCostStructure<int>>
+    class SimulatedAnnealingTimeBased : public AbstractSimulatedAnnealing<Input, State, Move, CostStructure>
+    {
+    public:
+      using AbstractSimulatedAnnealing<Input, State, Move, CostStructure>::AbstractSimulatedAnnealing;
+
+    protected:
+      void InitializeParameters();
+      void InitializeRun();
+      void CompleteIteration();
+      bool StopCriterion();
+      /** Recomputes the number of neighbors to be sampled at each of the remaining temperatures. */
+      void UpdateNeighborsSampled();
+      /** Seconds elapsed since the beginning of the run. */
+      double ElapsedTime() const;
+
+      // additional parameters
+      Parameter<double> allowed_running_time;
+      Parameter<double> min_temperature;
+      Parameter<double> neighbors_accepted_ratio;
+      Parameter<unsigned int> calibration_neighbors;
+      std::chrono::steady_clock::time_point run_start;
+    };
+
+    /*************************************************************************
+     * Implementation
+     *************************************************************************/
+
+    template <class Input, class State, class Move, class CostStructure>
+    void SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::InitializeParameters()
+    {
+      AbstractSimulatedAnnealing<Input, State, Move, CostStructure>::InitializeParameters();
+      allowed_running_time("allowed_running_time", "Allowed running time (in seconds)", this->parameters);
+      min_temperature("min_temperature", "Minimum temperature", this->parameters);
+      neighbors_accepted_ratio("neighbors_accepted_ratio", "Ratio of neighbors accepted", this->parameters);
+      calibration_neighbors("calibration_neighbors", "Number of neighbors sampled at the first temperature", this->parameters);
+      calibration_neighbors = 1000;
+      this->max_neighbors_sampled = this->max_neighbors_accepted = 0;
+    }
+
+    /**
+     Initializes the run by invoking the companion superclass method and
+     starting the clock. The first temperature is used to measure the
+     evaluation rate, therefore it samples a fixed number of neighbors.
+     */
+    template <class Input, class State, class Move, class CostStructure>
+    void SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::InitializeRun()
+    {
+      if (allowed_running_time <= 0.0)
+        throw IncorrectParameterValue(allowed_running_time, "should be greater than zero");
+      if (min_temperature <= 0.0)
+        throw IncorrectParameterValue(min_temperature, "should be greater than zero");
+      if (calibration_neighbors == 0)
+        throw IncorrectParameterValue(calibration_neighbors, "should be greater than zero");
+      run_start = std::chrono::steady_clock::now();
+      AbstractSimulatedAnnealing<Input, State, Move, CostStructure>::InitializeRun();
+      if (this->temperature <= min_temperature)
+        throw IncorrectParameterValue(min_temperature, "should be lower than the start temperature");
+
+      this->max_neighbors_sampled = calibration_neighbors;
+      if (!neighbors_accepted_ratio.IsSet())
+        this->max_neighbors_accepted = this->max_neighbors_sampled;
+      else
+        this->max_neighbors_accepted = static_cast<unsigned int>(this->max_neighbors_sampled * neighbors_accepted_ratio);
+    }
+
+    /**
+     After each cooling step the number of neighbors sampled per temperature
+     is adapted to the time left.
+     */
+    template <class Input, class State, class Move, class CostStructure>
+    void SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::CompleteIteration()
+    {
+      double previous_temperature = this->temperature;
+      AbstractSimulatedAnnealing<Input, State, Move, CostStructure>::CompleteIteration();
+      if (this->temperature < previous_temperature)
+        UpdateNeighborsSampled();
+    }
+
+    template <class Input, class State, class Move, class CostStructure>
+    void SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::UpdateNeighborsSampled()
+    {
+      double elapsed = ElapsedTime();
+      double remaining_time = allowed_running_time - elapsed;
+      double remaining_temperatures = ceil(log(min_temperature / this->temperature) / log(this->cooling_rate));
+      if (remaining_time <= 0.0 || remaining_temperatures < 1.0 || elapsed <= 0.0)
+        return;
+      double evaluation_rate = this->evaluations / elapsed;
+      this->max_neighbors_sampled = std::max(1u, static_cast<unsigned int>(std::min(evaluation_rate * remaining_time / remaining_temperatures, static_cast<double>(std::numeric_limits<unsigned int>::max()))));
+      if (!neighbors_accepted_ratio.IsSet())
+        this->max_neighbors_accepted = this->max_neighbors_sampled;
+      else
+        this->max_neighbors_accepted = std::max(1u, static_cast<unsigned int>(this->max_neighbors_sampled * neighbors_accepted_ratio));
+    }
+
+    template <class Input, class State, class Move, class CostStructure>
+    double SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::ElapsedTime() const
+    {
+      return std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1>>>(std::chrono::steady_clock::now() - run_start).count();
+    }
+
+    /**
+     The search stops when the minimum temperature is reached or the allowed
+     running time has expired.
+     */
+    template <class Input, class State, class Move, class CostStructure>
+    bool SimulatedAnnealingTimeBased<Input, State, Move, CostStructure>::StopCriterion()
+    {
+      return this->temperature <= min_temperature || ElapsedTime() >= allowed_running_time;
+    }
+  } // namespace Core
+} // namespace EasyLocal
@@ -7,6 +7,7 @@
 #include "solvers/simplelocalsearch.hh"
 //#include "solvers/variableneighborhooddescent.hh"
 #include "solvers/tokenringsearch.hh"
+#include "solvers/iteratedlocalsearch.hh"
 //#include "solvers/generalizedlocalsearch.hh"
-//#include "solvers/grasp.hh"
+#include "solvers/grasp.hh"
 
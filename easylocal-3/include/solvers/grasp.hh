@@ -1,8 +1,15 @@
-#prgama once
+#pragma once
 
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
-#include "easylocal/solvers/abstractlocalsearch.hh"
+#include "helpers/statemanager.hh"
+#include "helpers/outputmanager.hh"
+#include "solvers/abstractlocalsearch.hh"
+#include "runners/runner.hh"
+#include "utils/random.hh"
 
 namespace EasyLocal
 {
@@ -10,138 +17,177 @@ namespace EasyLocal
 namespace Core
 {
 
-/** An Iterated Local Search solver handles both a runner encapsulating a local
-     search algorithm and a kicker used for perturbing current solution.
-     @ingroup Solvers */
+/** The GRASP solver repeats a randomized greedy construction, delegated to
+     the GreedyState(state, alpha, k) of the state manager, followed by a
+     local search, encapsulated in a runner. The trials are run in parallel,
+     by one thread for each runner attached: each thread owns its runner,
+     its state and its random engine (seeded from the solver seed), while the
+     state manager and the other helpers are shared, hence they must not
+     modify their own data in the const methods. The costs of all the
+     constructions and of all the local optima are kept, to look at their
+     distribution.
+     @ingroup Solvers
+     */
 template <class Input, class Output, class State, class CostStructure = DefaultCostStructure<int>>
 class GRASP
     : public AbstractLocalSearch<Input, Output, State, CostStructure>
 {
 public:
-  GRASP(const Input &i,
-        StateManager<Input, State, CostStructure> &sm,
-        OutputManager<Input, Output, State, CostStructure> &om,
+  typedef Runner<Input, State, CostStructure> RunnerType;
+  GRASP(const Input &in,
+        StateManager<Input, State, CostStructure> &e_sm,
+        OutputManager<Input, Output, State> &e_om,
         std::string name);
+  void AddRunner(RunnerType &r); /**< one thread is started for each runner. */
   void Print(std::ostream &os = std::cout) const;
-  void SetRunner(Runner<Input, State, CostStructure> &r);
-  unsigned int GetRestarts() const { return restarts; }
   void ReadParameters(std::istream &is = std::cin, std::ostream &os = std::cout);
-
-  void Solve(double alpha, unsigned int k, unsigned int restarts);
+  unsigned int Trials() const { return construction_costs.size(); }
+  const std::vector<CostStructure> &ConstructionCosts() const { return construction_costs; }
+  const std::vector<CostStructure> &DescentCosts() const { return descent_costs; }
 
 protected:
-  unsigned int restarts;
-
-  Runner<Input, State, CostStructure> *runner; /**< The linked runner. */
+  void Go();
+  void FindInitialState();
+  void AtTimeoutExpired();
+  void ResetTimeout();
+  virtual std::shared_ptr<State> GetCurrentState() const;
+  void RunTrials(RunnerType &r, unsigned int seed);
+
+  std::vector<RunnerType *> p_runners; /**< pointers to the managed runners. */
+  void InitializeParameters();
+  Parameter<unsigned int> max_trials;
+  Parameter<double> alpha;
+  Parameter<unsigned int> k;
+  std::atomic<unsigned int> next_trial;
+  std::vector<CostStructure> construction_costs, descent_costs; /**< in the order of completion of the trials. */
+  mutable std::mutex best_mutex; /**< guards the best state and the costs. */
 };
 
 /*************************************************************************
      * Implementation
      *************************************************************************/
 
-/**
-     Constructs an iterated local search solver by providing it links to
-     a state manager, an output manager, a runner, a kicker, an input,
-     and an output object.
-     
-     @param sm a pointer to a compatible state manager
-     @param om a pointer to a compatible output manager
-     @param r a pointer to a compatible runner
-     @param k a pointer to a compatible kicker
-     @param in a pointer to an input object
-     @param out a pointer to an output object
-     */
 template <class Input, class Output, class State, class CostStructure>
-GRASP<Input, Output, State, CostStructure>::GRASP(const Input &i,
-                                                  StateManager<Input, State, CostStructure> &sm,
-                                                  OutputManager<Input, Output, State, CostStructure> &om,
+GRASP<Input, Output, State, CostStructure>::GRASP(const Input &in,
+                                                  StateManager<Input, State, CostStructure> &e_sm,
+                                                  OutputManager<Input, Output, State> &e_om,
                                                   std::string name)
-    : AbstractLocalSearch<Input, Output, State, CostStructure>(i, sm, om, name)
+    : AbstractLocalSearch<Input, Output, State, CostStructure>(in, e_sm, e_om, name)
 {
-  runner = nullptr;
 }
 
-/**
-     Set the runner.
-     
-     @param r a pointer to a compatible runner to add
-     */
 template <class Input, class Output, class State, class CostStructure>
-void GRASP<Input, Output, State, CostStructure>::SetRunner(Runner<Input, State, CostStructure> &r)
+void GRASP<Input, Output, State, CostStructure>::InitializeParameters()
 {
-  runner = &r;
+  AbstractLocalSearch<Input, Output, State, CostStructure>::InitializeParameters();
+  max_trials("max_trials", "Number of constructions (each one followed by the local search)", this->parameters);
+  alpha("alpha", "Width of the restricted candidate list, from 0 (greedy) to 1 (random)", this->parameters);
+  k("k", "Size of the restricted candidate list (0: no bound, for the state managers that use it)", this->parameters);
+  max_trials = 100;
+  alpha = 0.1;
+  k = 0;
 }
 
-// template <class Input, class Output, class State, class CostStructure>
-// void GRASP<Input, Output, State, CostStructure>::Print(std::ostream& os) const
-// {
-//   os  << "Generalized Local Search Solver: " << this->name << std::endl;
-
-//   if (this->runners.size() > 0)
-//     for (unsigned int i = 0; i < this->runners.size(); i++)
-//       {
-// 	os  << "Runner[" << i << "]" << std::endl;
-// 	this->runners[i]->Print(os);
-//       }
-//   else
-//     os  << "<no runner attached>" << std::endl;
-//   if (p_kicker)
-//     p_kicker->Print(os);
-//   else
-//     os  << "<no kicker attached>" << std::endl;
-//   os << "Max idle rounds: " << max_idle_rounds << std::endl;
-//   os << "Timeout " << this->timeout << std::endl;
-// }
-
-/**
-     Solves using a single runner
-     */
 template <class Input, class Output, class State, class CostStructure>
-void GRASP<Input, Output, State, CostStructure>::Solve(double alpha, unsigned int k, unsigned int trials)
+void GRASP<Input, Output, State, CostStructure>::ReadParameters(std::istream &is, std::ostream &os)
 {
-  bool timeout_expired = false;
-  unsigned t;
-  if (runner == nullptr)
-    throw std::logic_error("No runner set for solver " + this->name);
-  //   chrono.Reset();
-  //   chrono.Start();
-  for (t = 0; t < trials; t++)
+  os << "GRASP Solver: " << this->name << " parameters" << std::endl;
+  CommandLineParameters::Parametrized::ReadParameters(is, os);
+  for (unsigned int i = 0; i < p_runners.size(); i++)
   {
-    this->sm.GreedyState(this->current_state, alpha, k);
-    runner->SetState(this->current_state);
-    timeout_expired = LetGo(*runner);
+    os << "Runner[" << i << "]: " << std::endl;
+    p_runners[i]->ReadParameters(is, os);
+  }
+}
 
-    this->current_state = runner->GetState();
-    this->current_state_cost = runner->GetStateCost();
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::Print(std::ostream &os) const
+{
+  os << "GRASP Solver: " << this->name << std::endl;
+  if (p_runners.size() > 0)
+    for (unsigned int i = 0; i < p_runners.size(); i++)
+    {
+      os << "Runner[" << i << "]" << std::endl;
+      p_runners[i]->Print(os);
+    }
+  else
+    os << "<no runner attached>" << std::endl;
+}
 
-    if (t == 0 || LessThan(this->current_state_cost, this->best_state_cost))
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::AddRunner(RunnerType &r)
+{
+  p_runners.push_back(&r);
+}
+
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::FindInitialState()
+{ // each trial builds its own state
+  construction_costs.clear();
+  descent_costs.clear();
+}
+
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::Go()
+{
+  std::vector<std::thread> workers;
+  unsigned int seed = Random::GetSeed();
+
+  if (p_runners.empty())
+    // FIXME: add a more specific exception behavior
+    throw std::logic_error("No runner set in object " + this->name);
+
+  next_trial = 0;
+  for (unsigned int t = 0; t < p_runners.size(); t++)
+    workers.emplace_back(&GRASP::RunTrials, this, std::ref(*p_runners[t]), seed + t);
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::RunTrials(RunnerType &r, unsigned int seed)
+{
+  State st(this->in);
+  CostStructure construction_cost, descent_cost;
+
+  Random::SetThreadSeed(seed);
+  while (next_trial++ < max_trials && !this->TimeoutExpired())
+  {
+    this->sm.GreedyState(st, alpha, k);
+    construction_cost = this->sm.CostFunctionComponents(st);
+    descent_cost = r.Go(st);
+
+    std::lock_guard<std::mutex> lock(best_mutex);
+    construction_costs.push_back(construction_cost);
+    descent_costs.push_back(descent_cost);
+    if (descent_costs.size() == 1 || descent_cost < this->best_state_cost)
     {
-      this->best_state = this->current_state;
-      this->best_state_cost = this->current_state_cost;
-      if (this->sm.LowerBoundReached(this->best_state_cost))
-        break;
+      *this->p_best_state = st;
+      this->best_state_cost = descent_cost;
     }
-    if (timeout_expired)
-      break;
   }
-  //   chrono.Stop();
 }
 
 template <class Input, class Output, class State, class CostStructure>
-void GRASP<Input, Output, State, CostStructure>::ReadParameters(std::istream &is, std::ostream &os)
+void GRASP<Input, Output, State, CostStructure>::AtTimeoutExpired()
 {
-  os << "GRASP Solver: " << this->name << " parameters" << std::endl;
-  os << "Runner: " << std::endl;
-
-  this->runner->ReadParameters(is, os);
+  for (RunnerType *r : p_runners)
+    r->Interrupt();
+}
 
-#if defined(HAVE_PTHREAD)
-  double timeout;
-  os << "Timeout: ";
-  is >> timeout;
-  this->SetTimeout(timeout);
-#endif
+template <class Input, class Output, class State, class CostStructure>
+void GRASP<Input, Output, State, CostStructure>::ResetTimeout()
+{
+  Interruptible<int>::ResetTimeout();
+  for (RunnerType *r : p_runners)
+    r->ResetTimeout();
 }
 
+template <class Input, class Output, class State, class CostStructure>
+std::shared_ptr<State> GRASP<Input, Output, State, CostStructure>::GetCurrentState() const
+{
+  std::lock_guard<std::mutex> lock(best_mutex);
+  return std::make_shared<State>(*this->p_best_state);
+}
 } // namespace Core
 } // namespace EasyLocal
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <future>
+
+#include "helpers/statemanager.hh"
+#include "helpers/outputmanager.hh"
+#include "helpers/kicker.hh"
+#include "solvers/abstractlocalsearch.hh"
+#include "runners/runner.hh"
+
+namespace EasyLocal
+{
+
+namespace Core
+{
+
+/** The Iterated Local Search solver alternates a local search, encapsulated
+     in a runner, with random kicks that perturb the local optimum it reaches.
+     The search restarts from the best state whenever a round does not
+     improve on it. The kick length adapts to the stagnation: it grows by
+     one at each idle round, up to max_kick_length, and goes back to
+     min_kick_length as soon as a new best state is found.
+     @ingroup Solvers
+     */
+template <class Input, class Output, class State, class Move, class CostStructure = DefaultCostStructure<int>>
+class IteratedLocalSearch
+    : public AbstractLocalSearch<Input, Output, State, CostStructure>
+{
+public:
+  typedef Runner<Input, State, CostStructure> RunnerType;
+  typedef Kicker<Input, State, Move, CostStructure> KickerType;
+  IteratedLocalSearch(const Input &in,
+                      StateManager<Input, State, CostStructure> &e_sm,
+                      OutputManager<Input, Output, State> &e_om,
+                      std::string name);
+  void SetRunner(RunnerType &r);
+  void SetKicker(KickerType &k);
+  void Print(std::ostream &os = std::cout) const;
+  void ReadParameters(std::istream &is = std::cin, std::ostream &os = std::cout);
+  unsigned int Round() const { return round; }
+  unsigned int IdleRounds() const { return idle_rounds; }
+
+protected:
+  void Go();
+  void AtTimeoutExpired();
+  void ResetTimeout();
+  virtual std::shared_ptr<State> GetCurrentState() const;
+
+  RunnerType *p_runner; /**< pointer to the managed runner. */
+  KickerType *p_kicker; /**< pointer to the managed kicker. */
+  void InitializeParameters();
+  Parameter<unsigned int> max_rounds, max_idle_rounds;
+  Parameter<unsigned int> min_kick_length, max_kick_length;
+  unsigned int round;
+  unsigned int idle_rounds;
+  unsigned int kick_length;
+};
+
+/*************************************************************************
+     * Implementation
+     *************************************************************************/
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+IteratedLocalSearch<Input, Output, State, Move, CostStructure>::IteratedLocalSearch(const Input &in,
+                                                                                   StateManager<Input, State, CostStructure> &e_sm,
+                                                                                   OutputManager<Input, Output, State> &e_om,
+                                                                                   std::string name)
+    : AbstractLocalSearch<Input, Output, State, CostStructure>(in, e_sm, e_om, name), p_runner(nullptr), p_kicker(nullptr)
+{
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::InitializeParameters()
+{
+  AbstractLocalSearch<Input, Output, State, CostStructure>::InitializeParameters();
+  max_rounds("max_rounds", "Maximum number of rounds", this->parameters);
+  max_idle_rounds("max_idle_rounds", "Maximum number of idle rounds", this->parameters);
+  min_kick_length("min_kick_length", "Kick length after an improvement", this->parameters);
+  max_kick_length("max_kick_length", "Maximum kick length reached by the stagnation", this->parameters);
+  max_rounds = std::numeric_limits<unsigned int>::max();
+  max_idle_rounds = 100;
+  min_kick_length = 2;
+  max_kick_length = 10;
+  round = 0;
+  idle_rounds = 0;
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::ReadParameters(std::istream &is, std::ostream &os)
+{
+  os << "Iterated Local Search Solver: " << this->name << " parameters" << std::endl;
+  CommandLineParameters::Parametrized::ReadParameters(is, os);
+  os << "Runner: " << std::endl;
+  if (this->p_runner)
+    this->p_runner->ReadParameters(is, os);
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::Print(std::ostream &os) const
+{
+  os << "Iterated Local Search Solver: " << this->name << std::endl;
+  if (this->p_runner)
+    this->p_runner->Print(os);
+  else
+    os << "<no runner attached>" << std::endl;
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::SetRunner(RunnerType &r)
+{
+  p_runner = &r;
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::SetKicker(KickerType &k)
+{
+  p_kicker = &k;
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::Go()
+{
+  if (!p_runner || !p_kicker)
+    // FIXME: add a more specific exception behavior
+    throw std::logic_error("Runner or kicker not set in object " + this->name);
+  if (min_kick_length == 0 || max_kick_length < min_kick_length)
+    throw IncorrectParameterValue(max_kick_length, "It should be greater than or equal to min_kick_length, which should be positive");
+
+  round = 0;
+  idle_rounds = 0;
+  kick_length = min_kick_length;
+
+  this->current_state_cost = p_runner->Go(*this->p_current_state);
+  *this->p_best_state = *this->p_current_state;
+  this->best_state_cost = this->current_state_cost;
+
+  while (idle_rounds < max_idle_rounds && round < max_rounds && !this->TimeoutExpired())
+  {
+    try
+    {
+      Kick<State, Move, CostStructure> kick;
+      CostStructure kick_cost;
+      std::tie(kick, kick_cost) = p_kicker->SelectRandom(kick_length, *this->p_current_state);
+      p_kicker->MakeKick(*this->p_current_state, kick);
+    }
+    catch (EmptyNeighborhood &)
+    {
+      break;
+    }
+    this->current_state_cost = p_runner->Go(*this->p_current_state);
+    round++;
+    idle_rounds++;
+    if (this->current_state_cost < this->best_state_cost)
+    {
+      idle_rounds = 0;
+      kick_length = min_kick_length;
+      *this->p_best_state = *this->p_current_state;
+      this->best_state_cost = this->current_state_cost;
+    }
+    else
+    { // the next kick starts again from the best state, with a stronger perturbation
+      if (kick_length < max_kick_length)
+        kick_length++;
+      *this->p_current_state = *this->p_best_state;
+      this->current_state_cost = this->best_state_cost;
+    }
+  }
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::AtTimeoutExpired()
+{
+  p_runner->Interrupt();
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+void IteratedLocalSearch<Input, Output, State, Move, CostStructure>::ResetTimeout()
+{
+  Interruptible<int>::ResetTimeout();
+  p_runner->ResetTimeout();
+}
+
+template <class Input, class Output, class State, class Move, class CostStructure>
+std::shared_ptr<State> IteratedLocalSearch<Input, Output, State, Move, CostStructure>::GetCurrentState() const
+{
+  return p_runner->GetCurrentBestState();
+}
+} // namespace Core
+} // namespace EasyLocal
@@ -160,7 +160,7 @@ namespace EasyLocal
           kicker.MakeKick(st, kick);
         return execute_kick;
       }
-      catch (EmptyNeighborhood)
+      catch (EmptyNeighborhood &)
       {
         os << "Empty neighborhood." << std::endl;
         return false;
@@ -2,6 +2,7 @@
 
 #include <random>
 #include <iostream>
+#include <memory>
 
 namespace EasyLocal
 {
@@ -49,6 +50,14 @@ namespace EasyLocal
         return r.seed = seed;
       }
       
+      /** Gives the calling thread its own random engine, seeded with the given value
+       (threads running in parallel would otherwise share the global engine). */
+      static unsigned int SetThreadSeed(unsigned int seed)
+      {
+        ThreadInstance().reset(new Random());
+        return SetSeed(seed);
+      }
+      
       static unsigned int GetSeed()
       {
         return GetInstance().seed;
@@ -62,10 +71,18 @@ namespace EasyLocal
       
     private:
       static Random& GetInstance() {
+        std::unique_ptr<Random>& thread_instance = ThreadInstance();
+        if (thread_instance)
+          return *thread_instance;
         static Random instance;
         return instance;
       }
       
+      static std::unique_ptr<Random>& ThreadInstance() {
+        thread_local std::unique_ptr<Random> instance;
+        return instance;
+      }
+      
       Random()
       {
         std::random_device dev;
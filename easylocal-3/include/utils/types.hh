@@ -4,6 +4,7 @@
 #include <iostream>
 #include <cmath>
 #include <regex>
+#include <limits>
 
 /* template <class T,
  typename std::enable_if<std::is_integral<T>::value,